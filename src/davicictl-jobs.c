@@ -0,0 +1,460 @@
+/*
+ *  Davici Utilities for Strongswan
+ *  Copyright (C) 2026 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __SRC_DAVICICTL_JOBS_C 1
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include "davicictl.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#include <davici.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#define MY_JOBS_DEPTH         4
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+#pragma mark - Datatypes
+
+typedef struct _my_job        my_job_t;
+
+
+struct _my_job
+{  int                           rc;
+   int                           is_event;
+   int                           done;
+   int                           was_item;
+   int                           end_item;
+   unsigned                      last_id;
+   unsigned                      end_id;
+   my_sock_t *                   sock;
+   my_buffer_t                   tape;
+   my_buffer_t                   tape_data;
+   my_buffer_t                   out;
+};
+
+
+struct _my_jobs
+{  int                           closing;
+   unsigned                      workers;
+   size_t                        slots;
+   uintmax_t                     head;
+   uintmax_t                     next;
+   uintmax_t                     tail;
+   uintmax_t                     formatted;
+   uintmax_t                     reformatted;
+   char *                        name;
+   my_config_t *                 cnf;
+   my_config_t *                 cnfs;
+   my_job_t *                    job;
+   pthread_t *                   threads;
+   pthread_mutex_t               lock;
+   pthread_cond_t                ready;
+   pthread_cond_t                finished;
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static void
+my_jobs_clone_free(
+         my_config_t *                 wcnf );
+
+
+static int
+my_jobs_spawn(
+         my_config_t *                 cnf );
+
+
+static void *
+my_jobs_thread(
+         void *                        arg );
+
+
+static int
+my_jobs_write(
+         my_config_t *                 cnf,
+         uintmax_t                     until );
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+void
+my_jobs_clone_free(
+         my_config_t *                 wcnf )
+{
+   free(wcnf->out.data);
+   free(wcnf->where);
+   my_buffer_free(&wcnf->msg_buff);
+   my_buffer_free(&wcnf->msg_stack);
+   my_buffer_free(&wcnf->path);
+   my_buffer_free(&wcnf->path_offs);
+   my_buffer_free(&wcnf->tape);
+   my_buffer_free(&wcnf->tape_data);
+   my_buffer_free(&wcnf->replay_path);
+   my_buffer_free(&wcnf->replay_offs);
+   my_buffer_free(&wcnf->sects);
+   my_buffer_free(&wcnf->sects_offs);
+   return;
+}
+
+
+int
+my_jobs_drain(
+         my_config_t *                 cnf )
+{
+   if (!(cnf->jobs))
+      return(0);
+   return(my_jobs_write(cnf, cnf->jobs->head));
+}
+
+
+int
+my_jobs_spawn(
+         my_config_t *                 cnf )
+{
+   int               rc;
+   unsigned          pos;
+   my_jobs_t *       jobs;
+   my_config_t *     wcnf;
+
+   jobs = cnf->jobs;
+
+   if ((jobs->job = calloc((size_t)cnf->opt_jobs * MY_JOBS_DEPTH, sizeof(my_job_t))) == NULL)
+      return(-ENOMEM);
+   jobs->slots = (size_t)cnf->opt_jobs * MY_JOBS_DEPTH;
+   if ((jobs->cnfs = calloc(cnf->opt_jobs, sizeof(my_config_t))) == NULL)
+      return(-ENOMEM);
+   if ((jobs->threads = calloc(cnf->opt_jobs, sizeof(pthread_t))) == NULL)
+      return(-ENOMEM);
+
+   // each thread formats using a copy of the configuration with buffers
+   // of its own, compiled paths and the emitter are shared read-only
+   for(pos = 0; (pos < cnf->opt_jobs); pos++)
+   {  wcnf = &jobs->cnfs[pos];
+      memcpy(wcnf, cnf, sizeof(my_config_t));
+      memset(&wcnf->out,         0, sizeof(my_buffer_t));
+      memset(&wcnf->msg_buff,    0, sizeof(my_buffer_t));
+      memset(&wcnf->msg_stack,   0, sizeof(my_buffer_t));
+      memset(&wcnf->path,        0, sizeof(my_buffer_t));
+      memset(&wcnf->path_offs,   0, sizeof(my_buffer_t));
+      memset(&wcnf->tape,        0, sizeof(my_buffer_t));
+      memset(&wcnf->tape_data,   0, sizeof(my_buffer_t));
+      memset(&wcnf->replay_path, 0, sizeof(my_buffer_t));
+      memset(&wcnf->replay_offs, 0, sizeof(my_buffer_t));
+      memset(&wcnf->sects,       0, sizeof(my_buffer_t));
+      memset(&wcnf->sects_offs,  0, sizeof(my_buffer_t));
+      wcnf->where          = NULL;
+      wcnf->writer         = NULL;
+      wcnf->emitter_state  = NULL;
+      wcnf->out_capture    = NULL;
+      wcnf->out_err        = 0;
+      if ((wcnf->out.data = malloc(cnf->out.size)) == NULL)
+         return(-ENOMEM);
+      wcnf->out.size = cnf->out.size;
+      if ((cnf->where_len))
+      {  if ((wcnf->where = malloc(sizeof(my_where_t) * cnf->where_len)) == NULL)
+            return(-ENOMEM);
+         memcpy(wcnf->where, cnf->where, sizeof(my_where_t) * cnf->where_len);
+      };
+   };
+
+   my_verbose(cnf, "starting %u formatting threads ...\n", cnf->opt_jobs);
+   for(pos = 0; (pos < cnf->opt_jobs); pos++)
+   {  if ((rc = pthread_create(&jobs->threads[pos], NULL, &my_jobs_thread, &jobs->cnfs[pos])) != 0)
+      {  fprintf(stderr, "%s: pthread_create(): %s\n", my_prog_name(cnf), strerror(rc));
+         return(-rc);
+      };
+      jobs->workers++;
+   };
+
+   return(0);
+}
+
+
+void
+my_jobs_stop(
+         my_config_t *                 cnf )
+{
+   size_t            pos;
+   my_jobs_t *       jobs;
+
+   if ((jobs = cnf->jobs) == NULL)
+      return;
+   cnf->jobs = NULL;
+
+   // messages which were not written are discarded
+   pthread_mutex_lock(&jobs->lock);
+   jobs->closing = 1;
+   pthread_cond_broadcast(&jobs->ready);
+   pthread_mutex_unlock(&jobs->lock);
+   for(pos = 0; (pos < jobs->workers); pos++)
+      pthread_join(jobs->threads[pos], NULL);
+
+   if ((jobs->workers))
+      my_verbose(cnf, "formatting threads: %ju messages formatted by %u threads, %ju reformatted\n", jobs->formatted, jobs->workers, jobs->reformatted);
+
+   if ((jobs->cnfs))
+      for(pos = 0; (pos < cnf->opt_jobs); pos++)
+         my_jobs_clone_free(&jobs->cnfs[pos]);
+   for(pos = 0; (pos < jobs->slots); pos++)
+   {  my_buffer_free(&jobs->job[pos].tape);
+      my_buffer_free(&jobs->job[pos].tape_data);
+      my_buffer_free(&jobs->job[pos].out);
+   };
+   free(jobs->job);
+   free(jobs->cnfs);
+   free(jobs->threads);
+   free(jobs->name);
+   pthread_cond_destroy(&jobs->finished);
+   pthread_cond_destroy(&jobs->ready);
+   pthread_mutex_destroy(&jobs->lock);
+   free(jobs);
+
+   return;
+}
+
+
+int
+my_jobs_submit(
+         my_config_t *                 cnf,
+         const char *                  name,
+         struct davici_response *      res,
+         int                           is_event )
+{
+   int               rc;
+   int               is_record;
+   my_job_t *        job;
+   my_jobs_t *       jobs;
+
+   // only records streamed as events are formatted by threads, formats
+   // which keep state of their own across messages are formatted serially
+   is_record = ( ((cnf->widget)) && (((cnf->flags | cnf->widget->flags) & MY_FLG_RECORDS)) ) ? 1 : 0;
+   if ( (cnf->opt_jobs < 2) || (!(is_event)) || (!(is_record)) || ((cnf->emitter_state)) )
+   {  rc = my_jobs_drain(cnf);
+      return((rc < 0) ? rc : 1);
+   };
+
+   // the first message of a run of messages with the same name is
+   // formatted serially and determines the state of the emitter which is
+   // expected by the following messages
+   if ( (!(cnf->jobs)) || (strcmp(cnf->jobs->name, name)) )
+   {  if ((rc = my_jobs_drain(cnf)) < 0)
+         return(rc);
+      if ((jobs = cnf->jobs) == NULL)
+      {  if ((jobs = calloc(1, sizeof(my_jobs_t))) == NULL)
+         {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+            return(-ENOMEM);
+         };
+         jobs->cnf = cnf;
+         pthread_mutex_init(&jobs->lock, NULL);
+         pthread_cond_init(&jobs->ready, NULL);
+         pthread_cond_init(&jobs->finished, NULL);
+         cnf->jobs = jobs;
+      };
+      free(jobs->name);
+      if ((jobs->name = strdup(name)) == NULL)
+      {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+         return(-ENOMEM);
+      };
+      return(1);
+   };
+   jobs = cnf->jobs;
+
+   // threads are started once a run contains more than one message
+   if (!(jobs->slots))
+   {  if ((rc = my_jobs_spawn(cnf)) == -ENOMEM)
+         fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      if (rc < 0)
+         return(rc);
+   };
+
+   // wait for the oldest message if all slots are in use
+   if ((jobs->head - jobs->tail) >= jobs->slots)
+      if ((rc = my_jobs_write(cnf, jobs->tail + 1)) < 0)
+         return(rc);
+
+   // copy message out of the response, the emitter is expected to be in
+   // the same state as after the most recently written message
+   job = &jobs->job[jobs->head % jobs->slots];
+   if ((rc = my_parse_snapshot(res, &job->tape, &job->tape_data)) < 0)
+   {  fprintf(stderr, "%s: %s: %s\n", my_prog_name(cnf), name, strerror(-rc));
+      return(rc);
+   };
+   job->is_event  = is_event;
+   job->was_item  = cnf->last_was_item;
+   job->last_id   = cnf->res_last_id;
+   job->sock      = cnf->sock;
+   job->done      = 0;
+
+   pthread_mutex_lock(&jobs->lock);
+   jobs->head++;
+   pthread_cond_signal(&jobs->ready);
+   pthread_mutex_unlock(&jobs->lock);
+
+   // write messages which have been formatted
+   return(my_jobs_write(cnf, jobs->tail));
+}
+
+
+void *
+my_jobs_thread(
+         void *                        arg )
+{
+   my_job_t *        job;
+   my_jobs_t *       jobs;
+   my_config_t *     cnf;
+
+   cnf  = arg;
+   jobs = cnf->jobs;
+
+   pthread_mutex_lock(&jobs->lock);
+   while(1)
+   {  // wait for queued messages
+      while ( (jobs->next == jobs->head) && (!(jobs->closing)) )
+         pthread_cond_wait(&jobs->ready, &jobs->lock);
+      if ((jobs->closing))
+         break;
+      job = &jobs->job[jobs->next++ % jobs->slots];
+
+      // interned names are only added while no messages are queued
+      cnf->names        = jobs->cnf->names;
+      cnf->names_size   = jobs->cnf->names_size;
+      cnf->names_len    = jobs->cnf->names_len;
+      cnf->names_data   = jobs->cnf->names_data;
+      pthread_mutex_unlock(&jobs->lock);
+
+      // format message into buffer of job starting with expected state
+      job->out.len         = 0;
+      cnf->out.len         = 0;
+      cnf->out_capture     = &job->out;
+      cnf->last_was_item   = job->was_item;
+      cnf->res_last_id     = job->last_id;
+      cnf->res_id          = job->last_id;
+      cnf->sock            = job->sock;
+      if ((job->rc = my_parse_tape(cnf, jobs->name, &job->tape, &job->tape_data, job->is_event)) >= 0)
+         job->rc = my_out_flush(cnf);
+      job->end_item  = cnf->last_was_item;
+      job->end_id    = cnf->res_last_id;
+
+      pthread_mutex_lock(&jobs->lock);
+      job->done = 1;
+      pthread_cond_signal(&jobs->finished);
+   };
+   pthread_mutex_unlock(&jobs->lock);
+
+   return(NULL);
+}
+
+
+int
+my_jobs_write(
+         my_config_t *                 cnf,
+         uintmax_t                     until )
+{
+   int               rc;
+   int               done;
+   my_job_t *        job;
+   my_jobs_t *       jobs;
+   my_sock_t *       sock;
+
+   jobs = cnf->jobs;
+
+   // messages are written in the order in which they were received
+   while (jobs->tail < jobs->head)
+   {  job = &jobs->job[jobs->tail % jobs->slots];
+      pthread_mutex_lock(&jobs->lock);
+      while ( (!(job->done)) && (jobs->tail < until) )
+         pthread_cond_wait(&jobs->finished, &jobs->lock);
+      done = job->done;
+      pthread_mutex_unlock(&jobs->lock);
+      if (!(done))
+         return(0);
+
+      // messages formatted from a state which differs from the state of
+      // the emitter are formatted again
+      if ( (job->was_item != cnf->last_was_item) || (job->last_id != cnf->res_last_id) )
+      {  jobs->reformatted++;
+         sock        = cnf->sock;
+         cnf->sock   = job->sock;
+         rc          = my_parse_tape(cnf, jobs->name, &job->tape, &job->tape_data, job->is_event);
+         cnf->sock   = sock;
+      } else if ((rc = job->rc) >= 0)
+      {  jobs->formatted++;
+         rc = my_out_write(cnf, job->out.data, job->out.len);
+         cnf->last_was_item   = job->end_item;
+         cnf->res_last_id     = job->end_id;
+         cnf->res_id          = job->end_id;
+      };
+      jobs->tail++;
+      if (rc < 0)
+         return(rc);
+   };
+
+   return(0);
+}
+
+
+/* end of source */
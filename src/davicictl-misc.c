@@ -54,6 +54,12 @@
 #include <signal.h>
 #include <ctype.h>
 #include <inttypes.h>
+#include <time.h>
+#include <sys/timerfd.h>
+
+#ifdef MY_USE_X86_SIMD
+#   include <immintrin.h>
+#endif
 
 
 ///////////////////
@@ -87,6 +93,89 @@
 //////////////////
 // MARK: - Prototypes
 
+static size_t
+my_base64_encode_scalar(
+         char *                        dst,
+         const uint8_t *               src,
+         size_t                        n );
+
+
+#ifdef MY_USE_X86_SIMD
+static size_t
+my_base64_encode_avx2(
+         char *                        dst,
+         const uint8_t *               src,
+         size_t                        n );
+
+
+static size_t
+my_base64_encode_ssse3(
+         char *                        dst,
+         const uint8_t *               src,
+         size_t                        n );
+#endif
+
+
+static size_t
+my_json_escape_span_scalar(
+         const uint8_t *               src,
+         size_t                        n );
+
+
+#ifdef MY_USE_X86_SIMD
+static size_t
+my_json_escape_span_avx2(
+         const uint8_t *               src,
+         size_t                        n );
+
+
+static size_t
+my_json_escape_span_sse2(
+         const uint8_t *               src,
+         size_t                        n );
+#endif
+
+
+static int
+my_utf8_is_text_scalar(
+         const uint8_t *               src,
+         size_t                        n );
+
+
+#ifdef MY_USE_X86_SIMD
+static int
+my_utf8_is_text_avx2(
+         const uint8_t *               src,
+         size_t                        n );
+
+
+static int
+my_utf8_is_text_ssse3(
+         const uint8_t *               src,
+         size_t                        n );
+#endif
+
+
+static size_t
+my_xml_escape_span_scalar(
+         const uint8_t *               src,
+         size_t                        n );
+
+
+#ifdef MY_USE_X86_SIMD
+static size_t
+my_xml_escape_span_avx2(
+         const uint8_t *               src,
+         size_t                        n );
+
+
+static size_t
+my_xml_escape_span_sse2(
+         const uint8_t *               src,
+         size_t                        n );
+#endif
+
+
 /////////////////
 //             //
 //  Variables  //
@@ -97,6 +186,52 @@
 // MARK: base64_chars[]
 static const char * my_base64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/=";
 
+// MARK: my_base64_encode_blocks
+static size_t (*my_base64_encode_blocks)(char *, const uint8_t *, size_t) = &my_base64_encode_scalar;
+
+// MARK: my_json_escape_span_func
+static size_t (*my_json_escape_span_func)(const uint8_t *, size_t) = &my_json_escape_span_scalar;
+
+// MARK: my_utf8_is_text_func
+static int (*my_utf8_is_text_func)(const uint8_t *, size_t) = &my_utf8_is_text_scalar;
+
+// MARK: my_xml_escape_span_func
+static size_t (*my_xml_escape_span_func)(const uint8_t *, size_t) = &my_xml_escape_span_scalar;
+
+#ifdef MY_USE_X86_SIMD
+// UTF-8 validation lookup tables indexed by nibble.  Each bit flags an
+// error class: too short (0x01), too long (0x02), overlong 3 byte (0x04),
+// too large (0x08), surrogate (0x10), overlong 2 byte (0x20), too large
+// 1000 or overlong 4 byte (0x40) and two continuations (0x80).  A
+// sequence is invalid when the classes of the high and low nibbles of a
+// byte and the high nibble of the following byte intersect.
+// MARK: my_utf8_byte1_high[]
+static const uint8_t my_utf8_byte1_high[16] =
+{  0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02, 0x02,
+   0x80, 0x80, 0x80, 0x80, 0x21, 0x01, 0x15, 0x49
+};
+
+// MARK: my_utf8_byte1_low[]
+static const uint8_t my_utf8_byte1_low[16] =
+{  0xe7, 0xa3, 0x83, 0x83, 0x8b, 0xcb, 0xcb, 0xcb,
+   0xcb, 0xcb, 0xcb, 0xcb, 0xcb, 0xdb, 0xcb, 0xcb
+};
+
+// MARK: my_utf8_byte2_high[]
+static const uint8_t my_utf8_byte2_high[16] =
+{  0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01, 0x01,
+   0xe6, 0xae, 0xba, 0xba, 0x01, 0x01, 0x01, 0x01
+};
+
+// MARK: my_utf8_incomplete[]
+static const uint8_t my_utf8_incomplete[32] =
+{  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+   0xff, 0xff, 0xff, 0xff, 0xff, 0xef, 0xdf, 0xbf
+};
+#endif
+
 
 /////////////////
 //             //
@@ -112,69 +247,408 @@ my_base64_encode(
          const uint8_t *               src,
          size_t                        n )
 {
-   size_t         req_len;
-   ssize_t        len;
-   size_t         dpos;
+   size_t         len;
    size_t         spos;
-   size_t         byte;
-   uint8_t *      dat;
+   uint32_t       bits;
 
    assert(dst != NULL);
-   assert(src != NULL);
+   assert( (src != NULL) || (n == 0) );
    assert(s   >  0);
 
    // determine if enough space is available to encode using base64
-   req_len = ((n / 3) + (((n % 3)) ? 1 : 0)) * 4;
-   if (s <= (req_len+1))
+   if (s <= MY_BASE64_LEN(n))
       return(-ENOBUFS);
 
-   dat = (uint8_t *)dst;
-
-   // calculates each digit's value
-   byte = 0;
-   dpos = 0;
-   for(spos = 0; (spos < n); spos++)
-   {
-      // MSB is Most Significant Bits  (0x80 == 10000000 ~= MSB)
-      // MB is middle bits             (0x7E == 01111110 ~= MB)
-      // LSB is Least Significant Bits (0x01 == 00000001 ~= LSB)
-      switch(byte)
-      {
-         case 0:
-         dat[dpos++]  = (src[spos] & 0xfc) >> 2;  // 6 MSB
-         dat[dpos++]  = (src[spos] & 0x03) << 4;  // 2 LSB
-         byte++;
+   // encode complete 3 byte groups
+   len   = my_base64_encode_blocks(dst, src, n);
+   spos  = (n / 3) * 3;
+
+   // encode remaining bytes with padding
+   switch(n - spos)
+   {  case 1:
+         bits        = ((uint32_t)src[spos]) << 16;
+         dst[len++]  = my_base64_chars[(bits >> 18) & 0x3f];
+         dst[len++]  = my_base64_chars[(bits >> 12) & 0x3f];
+         dst[len++]  = '=';
+         dst[len++]  = '=';
          break;
 
-         case 1:
-         dat[dpos-1] |= (src[spos] & 0xf0) >> 4;  // 4 MSB
-         dat[dpos++]  = (src[spos] & 0x0f) << 2;  // 4 LSB
-         byte++;
+      case 2:
+         bits        = (((uint32_t)src[spos]) << 16) | (((uint32_t)src[spos+1]) << 8);
+         dst[len++]  = my_base64_chars[(bits >> 18) & 0x3f];
+         dst[len++]  = my_base64_chars[(bits >> 12) & 0x3f];
+         dst[len++]  = my_base64_chars[(bits >>  6) & 0x3f];
+         dst[len++]  = '=';
          break;
 
-         case 2:
-         default:
-         dat[dpos-1] |= (src[spos] & 0xc0) >> 6;  // 2 MSB
-         dat[dpos++]  =  src[spos] & 0x3f;        // 6 LSB
-         byte = 0;
+      default:
          break;
-      };
    };
 
-   // encodes each value
-   for(len = 0; ((size_t)len) < dpos; len++)
-      dst[len] = my_base64_chars[dat[len]];
-
-   // add padding
-   for(; ((len % 4)); len++)
-      dst[len] = '=';
-
    dst[len] = '\0';
 
    return((int)len);
 }
 
 
+#ifdef MY_USE_X86_SIMD
+__attribute__((target("avx2")))
+size_t
+my_base64_encode_avx2(
+         char *                        dst,
+         const uint8_t *               src,
+         size_t                        n )
+{
+   size_t         spos;
+   size_t         dpos;
+   __m128i        lo;
+   __m128i        hi;
+   __m256i        in;
+   __m256i        t0;
+   __m256i        t1;
+   __m256i        idx;
+   __m256i        res;
+   __m256i        less;
+
+   const __m256i  shuf  = _mm256_setr_epi8(  1,  0,  2,  1,  4,  3,  5,  4,  7,  6,  8,  7, 10,  9, 11, 10,
+                                             1,  0,  2,  1,  4,  3,  5,  4,  7,  6,  8,  7, 10,  9, 11, 10 );
+   const __m256i  lut   = _mm256_setr_epi8(  'a'-26, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52,
+                                             '0'-52, '0'-52, '0'-52, '+'-62, '/'-63, 'A',    0,      0,
+                                             'a'-26, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52,
+                                             '0'-52, '0'-52, '0'-52, '+'-62, '/'-63, 'A',    0,      0 );
+
+   // each iteration encodes 24 bytes, but loads 28 bytes
+   for(spos = 0, dpos = 0; ((n - spos) >= 28); spos += 24, dpos += 32)
+   {  // spread 3 byte groups into 32 bit lanes
+      lo    = _mm_loadu_si128((const __m128i *)&src[spos]);
+      hi    = _mm_loadu_si128((const __m128i *)&src[spos+12]);
+      in    = _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1);
+      in    = _mm256_shuffle_epi8(in, shuf);
+
+      // split each lane into four 6 bit indices
+      t0    = _mm256_mulhi_epu16(_mm256_and_si256(in, _mm256_set1_epi32(0x0fc0fc00)), _mm256_set1_epi32(0x04000040));
+      t1    = _mm256_mullo_epi16(_mm256_and_si256(in, _mm256_set1_epi32(0x003f03f0)), _mm256_set1_epi32(0x01000010));
+      idx   = _mm256_or_si256(t0, t1);
+
+      // translate indices into base64 alphabet
+      res   = _mm256_subs_epu8(idx, _mm256_set1_epi8(51));
+      less  = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), idx);
+      res   = _mm256_or_si256(res, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+      res   = _mm256_add_epi8(_mm256_shuffle_epi8(lut, res), idx);
+
+      _mm256_storeu_si256((__m256i *)&dst[dpos], res);
+   };
+
+   return(dpos + my_base64_encode_ssse3(&dst[dpos], &src[spos], (n - spos)));
+}
+#endif
+
+
+size_t
+my_base64_encode_scalar(
+         char *                        dst,
+         const uint8_t *               src,
+         size_t                        n )
+{
+   size_t         spos;
+   size_t         dpos;
+   uint32_t       bits;
+
+   for(spos = 0, dpos = 0; ((n - spos) >= 3); spos += 3, dpos += 4)
+   {  bits        = (((uint32_t)src[spos]) << 16) | (((uint32_t)src[spos+1]) << 8) | ((uint32_t)src[spos+2]);
+      dst[dpos+0] = my_base64_chars[(bits >> 18) & 0x3f];
+      dst[dpos+1] = my_base64_chars[(bits >> 12) & 0x3f];
+      dst[dpos+2] = my_base64_chars[(bits >>  6) & 0x3f];
+      dst[dpos+3] = my_base64_chars[(bits      ) & 0x3f];
+   };
+
+   return(dpos);
+}
+
+
+#ifdef MY_USE_X86_SIMD
+__attribute__((target("ssse3")))
+size_t
+my_base64_encode_ssse3(
+         char *                        dst,
+         const uint8_t *               src,
+         size_t                        n )
+{
+   size_t         spos;
+   size_t         dpos;
+   __m128i        in;
+   __m128i        t0;
+   __m128i        t1;
+   __m128i        idx;
+   __m128i        res;
+   __m128i        less;
+
+   const __m128i  shuf  = _mm_setr_epi8(  1,  0,  2,  1,  4,  3,  5,  4,  7,  6,  8,  7, 10,  9, 11, 10 );
+   const __m128i  lut   = _mm_setr_epi8(  'a'-26, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52, '0'-52,
+                                          '0'-52, '0'-52, '0'-52, '+'-62, '/'-63, 'A',    0,      0 );
+
+   // each iteration encodes 12 bytes, but loads 16 bytes
+   for(spos = 0, dpos = 0; ((n - spos) >= 16); spos += 12, dpos += 16)
+   {  // spread 3 byte groups into 32 bit lanes
+      in    = _mm_loadu_si128((const __m128i *)&src[spos]);
+      in    = _mm_shuffle_epi8(in, shuf);
+
+      // split each lane into four 6 bit indices
+      t0    = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+      t1    = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+      idx   = _mm_or_si128(t0, t1);
+
+      // translate indices into base64 alphabet
+      res   = _mm_subs_epu8(idx, _mm_set1_epi8(51));
+      less  = _mm_cmpgt_epi8(_mm_set1_epi8(26), idx);
+      res   = _mm_or_si128(res, _mm_and_si128(less, _mm_set1_epi8(13)));
+      res   = _mm_add_epi8(_mm_shuffle_epi8(lut, res), idx);
+
+      _mm_storeu_si128((__m128i *)&dst[dpos], res);
+   };
+
+   return(dpos + my_base64_encode_scalar(&dst[dpos], &src[spos], (n - spos)));
+}
+#endif
+
+
+void *
+my_buffer_alloc(
+         my_buffer_t *                 buff,
+         size_t                        len )
+{
+   size_t         size;
+   char *         data;
+   void *         ptr;
+
+   assert(buff != NULL);
+
+   // grow buffer geometrically to amortize reallocations
+   if ((buff->size - buff->len) < len)
+   {  size = ((buff->size)) ? buff->size : MY_BUFF_SIZE;
+      while ((size - buff->len) < len)
+         size *= 2;
+      if ((data = realloc(buff->data, size)) == NULL)
+         return(NULL);
+      buff->data = data;
+      buff->size = size;
+   };
+
+   ptr         = &buff->data[buff->len];
+   buff->len  += len;
+
+   return(ptr);
+}
+
+
+void
+my_buffer_free(
+         my_buffer_t *                 buff )
+{
+   if (!(buff))
+      return;
+   free(buff->data);
+   memset(buff, 0, sizeof(my_buffer_t));
+   return;
+}
+
+
+int
+my_deadline_start(
+         my_config_t *                 cnf )
+{
+   int                  fd;
+   struct itimerspec    its;
+
+   if ((fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)) == -1)
+   {  fprintf(stderr, "%s: timerfd_create(): %s\n", my_prog_name(cnf), strerror(errno));
+      return(-1);
+   };
+
+   // timer expires once, after the deadline has passed
+   memset(&its, 0, sizeof(its));
+   its.it_value.tv_sec  = (time_t)(cnf->opt_deadline / 1000);
+   its.it_value.tv_nsec = (long)(cnf->opt_deadline % 1000) * 1000000L;
+   if (timerfd_settime(fd, 0, &its, NULL) == -1)
+   {  fprintf(stderr, "%s: timerfd_settime(): %s\n", my_prog_name(cnf), strerror(errno));
+      close(fd);
+      return(-1);
+   };
+
+   return(fd);
+}
+
+
+size_t
+my_json_escape_span(
+         const void *                  src,
+         size_t                        n )
+{
+   assert( (src != NULL) || (n == 0) );
+   return(my_json_escape_span_func(src, n));
+}
+
+
+#ifdef MY_USE_X86_SIMD
+__attribute__((target("avx2")))
+size_t
+my_json_escape_span_avx2(
+         const uint8_t *               src,
+         size_t                        n )
+{
+   size_t         pos;
+   uint32_t       mask;
+   __m256i        in;
+   __m256i        m;
+
+   const __m256i  quote = _mm256_set1_epi8('"');
+   const __m256i  bslash = _mm256_set1_epi8('\\');
+   const __m256i  ctl   = _mm256_set1_epi8(0x1f);
+
+   for(pos = 0; ((n - pos) >= 32); pos += 32)
+   {  in    = _mm256_loadu_si256((const __m256i *)&src[pos]);
+      m     = _mm256_or_si256(_mm256_cmpeq_epi8(in, quote), _mm256_cmpeq_epi8(in, bslash));
+      m     = _mm256_or_si256(m, _mm256_cmpeq_epi8(_mm256_max_epu8(in, ctl), ctl));
+      if ((mask = (uint32_t)_mm256_movemask_epi8(m)) != 0)
+         return(pos + (size_t)__builtin_ctz(mask));
+   };
+
+   return(pos + my_json_escape_span_sse2(&src[pos], (n - pos)));
+}
+#endif
+
+
+size_t
+my_json_escape_span_scalar(
+         const uint8_t *               src,
+         size_t                        n )
+{
+   size_t         pos;
+   for(pos = 0; (pos < n); pos++)
+      if ( (src[pos] < 0x20) || (src[pos] == '"') || (src[pos] == '\\') )
+         return(pos);
+   return(n);
+}
+
+
+#ifdef MY_USE_X86_SIMD
+__attribute__((target("sse2")))
+size_t
+my_json_escape_span_sse2(
+         const uint8_t *               src,
+         size_t                        n )
+{
+   size_t         pos;
+   uint32_t       mask;
+   __m128i        in;
+   __m128i        m;
+
+   const __m128i  quote = _mm_set1_epi8('"');
+   const __m128i  bslash = _mm_set1_epi8('\\');
+   const __m128i  ctl   = _mm_set1_epi8(0x1f);
+
+   for(pos = 0; ((n - pos) >= 16); pos += 16)
+   {  in    = _mm_loadu_si128((const __m128i *)&src[pos]);
+      m     = _mm_or_si128(_mm_cmpeq_epi8(in, quote), _mm_cmpeq_epi8(in, bslash));
+      m     = _mm_or_si128(m, _mm_cmpeq_epi8(_mm_max_epu8(in, ctl), ctl));
+      if ((mask = (uint32_t)_mm_movemask_epi8(m)) != 0)
+         return(pos + (size_t)__builtin_ctz(mask));
+   };
+
+   return(pos + my_json_escape_span_scalar(&src[pos], (n - pos)));
+}
+#endif
+
+
+void
+my_simd_init( void )
+{
+#ifdef MY_USE_X86_SIMD
+   __builtin_cpu_init();
+   if ((__builtin_cpu_supports("sse2")))
+   {  my_json_escape_span_func   = &my_json_escape_span_sse2;
+      my_xml_escape_span_func    = &my_xml_escape_span_sse2;
+   };
+   if ((__builtin_cpu_supports("ssse3")))
+   {  my_base64_encode_blocks    = &my_base64_encode_ssse3;
+      my_utf8_is_text_func       = &my_utf8_is_text_ssse3;
+   };
+   if ((__builtin_cpu_supports("avx2")))
+   {  my_base64_encode_blocks    = &my_base64_encode_avx2;
+      my_json_escape_span_func   = &my_json_escape_span_avx2;
+      my_utf8_is_text_func       = &my_utf8_is_text_avx2;
+      my_xml_escape_span_func    = &my_xml_escape_span_avx2;
+   };
+#endif
+   return;
+}
+
+
+void
+my_stats_dump(
+         my_config_t *                 cnf )
+{
+   double               elapsed;
+   my_stats_t *         stats;
+
+   stats    = &cnf->stats;
+   elapsed  = (double)(my_time_ns() - stats->started) / 1e9;
+   if (elapsed <= 0.0)
+      elapsed = 1e-9;
+
+   fprintf(stderr, "%s: %.3f s elapsed, %ju messages (%.1f/s), %ju bytes written (%.1f/s), %d requests outstanding\n",
+      my_prog_name(cnf), elapsed,
+      stats->messages, (double)stats->messages / elapsed,
+      stats->bytes,    (double)stats->bytes    / elapsed,
+      cnf->queued
+   );
+   if ((stats->messages))
+      fprintf(stderr, "%s: formatting latency: avg %.1f us, max %.1f us\n",
+         my_prog_name(cnf),
+         (double)stats->format_total / (double)stats->messages / 1e3,
+         (double)stats->format_max / 1e3
+      );
+   if ((stats->replies))
+      fprintf(stderr, "%s: response latency: avg %.3f ms, max %.3f ms (%ju responses)\n",
+         my_prog_name(cnf),
+         (double)stats->reply_total / (double)stats->replies / 1e6,
+         (double)stats->reply_max / 1e6,
+         stats->replies
+      );
+
+   return;
+}
+
+
+void
+my_stats_message(
+         my_config_t *                 cnf,
+         uint64_t                      started,
+         int                           is_reply )
+{
+   uint64_t             now;
+   uint64_t             elapsed;
+   my_stats_t *         stats;
+
+   stats                   = &cnf->stats;
+   now                     = my_time_ns();
+   elapsed                 = now - started;
+   stats->messages++;
+   stats->format_total    += elapsed;
+   stats->format_max       = (elapsed > stats->format_max) ? elapsed : stats->format_max;
+
+   // response latency is measured from when the requests were queued
+   if (!(is_reply))
+      return;
+   elapsed                 = now - stats->queued;
+   stats->replies++;
+   stats->reply_total     += elapsed;
+   stats->reply_max        = (elapsed > stats->reply_max) ? elapsed : stats->reply_max;
+
+   return;
+}
+
+
 size_t
 my_strlcat(
          char * restrict               dst,
@@ -222,4 +696,346 @@ my_strlcpy(
 }
 
 
+uint64_t
+my_time_ns( void )
+{
+   struct timespec      ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return( ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec );
+}
+
+
+int
+my_utf8_is_text(
+         const void *                  src,
+         size_t                        n )
+{
+   assert( (src != NULL) || (n == 0) );
+   return(my_utf8_is_text_func(src, n));
+}
+
+
+#ifdef MY_USE_X86_SIMD
+__attribute__((target("avx2")))
+int
+my_utf8_is_text_avx2(
+         const uint8_t *               src,
+         size_t                        n )
+{
+   size_t         pos;
+   __m256i        in;
+   __m256i        prev;
+   __m256i        prev1;
+   __m256i        prev2;
+   __m256i        prev3;
+   __m256i        carry;
+   __m256i        err;
+   __m256i        incomplete;
+   __m256i        sc;
+   __m256i        must23;
+   uint8_t        tail[32];
+
+   const __m256i  b1h   = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)my_utf8_byte1_high));
+   const __m256i  b1l   = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)my_utf8_byte1_low));
+   const __m256i  b2h   = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)my_utf8_byte2_high));
+   const __m256i  maxv  = _mm256_loadu_si256((const __m256i *)my_utf8_incomplete);
+   const __m256i  nib   = _mm256_set1_epi8(0x0f);
+
+   err         = _mm256_setzero_si256();
+   prev        = _mm256_setzero_si256();
+   incomplete  = _mm256_setzero_si256();
+
+   for(pos = 0; (pos < n); pos += 32)
+   {  // pad final block with spaces
+      if ((n - pos) >= 32)
+      {  in = _mm256_loadu_si256((const __m256i *)&src[pos]);
+      } else
+      {  memset(tail, ' ', sizeof(tail));
+         memcpy(tail, &src[pos], (n - pos));
+         in = _mm256_loadu_si256((const __m256i *)tail);
+      };
+
+      // reject control characters
+      sc = _mm256_or_si256(
+               _mm256_cmpeq_epi8(_mm256_max_epu8(in, _mm256_set1_epi8(0x1f)), _mm256_set1_epi8(0x1f)),
+               _mm256_cmpeq_epi8(in, _mm256_set1_epi8(0x7f))
+            );
+      if ((_mm256_movemask_epi8(sc)))
+         return(0);
+
+      // ASCII blocks only need to terminate the previous block
+      if (!(_mm256_movemask_epi8(in)))
+      {  err   = _mm256_or_si256(err, incomplete);
+         prev  = in;
+         continue;
+      };
+
+      // classify each byte along with the three preceding bytes
+      carry    = _mm256_permute2x128_si256(prev, in, 0x21);
+      prev1    = _mm256_alignr_epi8(in, carry, 15);
+      prev2    = _mm256_alignr_epi8(in, carry, 14);
+      prev3    = _mm256_alignr_epi8(in, carry, 13);
+      sc       = _mm256_and_si256(
+                     _mm256_and_si256(
+                        _mm256_shuffle_epi8(b1h, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nib)),
+                        _mm256_shuffle_epi8(b1l, _mm256_and_si256(prev1, nib))
+                     ),
+                     _mm256_shuffle_epi8(b2h, _mm256_and_si256(_mm256_srli_epi16(in, 4), nib))
+                  );
+      must23   = _mm256_or_si256(
+                     _mm256_subs_epu8(prev2, _mm256_set1_epi8((char)(0xe0 - 0x80))),
+                     _mm256_subs_epu8(prev3, _mm256_set1_epi8((char)(0xf0 - 0x80)))
+                  );
+      must23   = _mm256_and_si256(must23, _mm256_set1_epi8((char)0x80));
+      err      = _mm256_or_si256(err, _mm256_xor_si256(must23, sc));
+
+      incomplete  = _mm256_subs_epu8(in, maxv);
+      prev        = in;
+   };
+   err = _mm256_or_si256(err, incomplete);
+
+   return((_mm256_testz_si256(err, err)) ? 1 : 0);
+}
+#endif
+
+
+int
+my_utf8_is_text_scalar(
+         const uint8_t *               src,
+         size_t                        n )
+{
+   size_t         pos;
+   size_t         len;
+   uint8_t        c;
+   uint8_t        lo;
+   uint8_t        hi;
+   uint64_t       v;
+
+   for(pos = 0; (pos < n); pos += len)
+   {  // check 8 ASCII bytes at a time for non-ASCII and control bytes
+      if ((n - pos) >= 8)
+      {  memcpy(&v, &src[pos], sizeof(v));
+         if (!( ( v | ((v - UINT64_C(0x2020202020202020)) & ~v) | (((v ^ UINT64_C(0x7f7f7f7f7f7f7f7f)) - UINT64_C(0x0101010101010101)) & ~(v ^ UINT64_C(0x7f7f7f7f7f7f7f7f))) ) & UINT64_C(0x8080808080808080)))
+         {  len = 8;
+            continue;
+         };
+      };
+
+      // ASCII
+      if ((c = src[pos]) < 0x80)
+      {  if ( (c < 0x20) || (c == 0x7f) )
+            return(0);
+         len = 1;
+         continue;
+      };
+
+      // determine sequence length and valid range of second byte
+      lo = 0x80;
+      hi = 0xbf;
+      if      (c <  0xc2)  return(0);
+      else if (c <  0xe0)  len = 2;
+      else if (c == 0xe0)  { len = 3; lo = 0xa0; }
+      else if (c == 0xed)  { len = 3; hi = 0x9f; }
+      else if (c <  0xf0)  len = 3;
+      else if (c == 0xf0)  { len = 4; lo = 0x90; }
+      else if (c <  0xf4)  len = 4;
+      else if (c == 0xf4)  { len = 4; hi = 0x8f; }
+      else                 return(0);
+
+      if ((n - pos) < len)
+         return(0);
+      if ( (src[pos+1] < lo) || (src[pos+1] > hi) )
+         return(0);
+      if ( (len > 2) && ((src[pos+2] & 0xc0) != 0x80) )
+         return(0);
+      if ( (len > 3) && ((src[pos+3] & 0xc0) != 0x80) )
+         return(0);
+   };
+
+   return(1);
+}
+
+
+#ifdef MY_USE_X86_SIMD
+__attribute__((target("ssse3")))
+int
+my_utf8_is_text_ssse3(
+         const uint8_t *               src,
+         size_t                        n )
+{
+   size_t         pos;
+   __m128i        in;
+   __m128i        prev;
+   __m128i        prev1;
+   __m128i        prev2;
+   __m128i        prev3;
+   __m128i        err;
+   __m128i        incomplete;
+   __m128i        sc;
+   __m128i        must23;
+   uint8_t        tail[16];
+
+   const __m128i  b1h   = _mm_loadu_si128((const __m128i *)my_utf8_byte1_high);
+   const __m128i  b1l   = _mm_loadu_si128((const __m128i *)my_utf8_byte1_low);
+   const __m128i  b2h   = _mm_loadu_si128((const __m128i *)my_utf8_byte2_high);
+   const __m128i  maxv  = _mm_loadu_si128((const __m128i *)&my_utf8_incomplete[16]);
+   const __m128i  nib   = _mm_set1_epi8(0x0f);
+
+   err         = _mm_setzero_si128();
+   prev        = _mm_setzero_si128();
+   incomplete  = _mm_setzero_si128();
+
+   for(pos = 0; (pos < n); pos += 16)
+   {  // pad final block with spaces
+      if ((n - pos) >= 16)
+      {  in = _mm_loadu_si128((const __m128i *)&src[pos]);
+      } else
+      {  memset(tail, ' ', sizeof(tail));
+         memcpy(tail, &src[pos], (n - pos));
+         in = _mm_loadu_si128((const __m128i *)tail);
+      };
+
+      // reject control characters
+      sc = _mm_or_si128(
+               _mm_cmpeq_epi8(_mm_max_epu8(in, _mm_set1_epi8(0x1f)), _mm_set1_epi8(0x1f)),
+               _mm_cmpeq_epi8(in, _mm_set1_epi8(0x7f))
+            );
+      if ((_mm_movemask_epi8(sc)))
+         return(0);
+
+      // ASCII blocks only need to terminate the previous block
+      if (!(_mm_movemask_epi8(in)))
+      {  err   = _mm_or_si128(err, incomplete);
+         prev  = in;
+         continue;
+      };
+
+      // classify each byte along with the three preceding bytes
+      prev1    = _mm_alignr_epi8(in, prev, 15);
+      prev2    = _mm_alignr_epi8(in, prev, 14);
+      prev3    = _mm_alignr_epi8(in, prev, 13);
+      sc       = _mm_and_si128(
+                     _mm_and_si128(
+                        _mm_shuffle_epi8(b1h, _mm_and_si128(_mm_srli_epi16(prev1, 4), nib)),
+                        _mm_shuffle_epi8(b1l, _mm_and_si128(prev1, nib))
+                     ),
+                     _mm_shuffle_epi8(b2h, _mm_and_si128(_mm_srli_epi16(in, 4), nib))
+                  );
+      must23   = _mm_or_si128(
+                     _mm_subs_epu8(prev2, _mm_set1_epi8((char)(0xe0 - 0x80))),
+                     _mm_subs_epu8(prev3, _mm_set1_epi8((char)(0xf0 - 0x80)))
+                  );
+      must23   = _mm_and_si128(must23, _mm_set1_epi8((char)0x80));
+      err      = _mm_or_si128(err, _mm_xor_si128(must23, sc));
+
+      incomplete  = _mm_subs_epu8(in, maxv);
+      prev        = in;
+   };
+   err = _mm_or_si128(err, incomplete);
+
+   return((_mm_movemask_epi8(_mm_cmpeq_epi8(err, _mm_setzero_si128())) == 0xffff) ? 1 : 0);
+}
+#endif
+
+
+size_t
+my_xml_escape_span(
+         const void *                  src,
+         size_t                        n )
+{
+   assert( (src != NULL) || (n == 0) );
+   return(my_xml_escape_span_func(src, n));
+}
+
+
+#ifdef MY_USE_X86_SIMD
+__attribute__((target("avx2")))
+size_t
+my_xml_escape_span_avx2(
+         const uint8_t *               src,
+         size_t                        n )
+{
+   size_t         pos;
+   uint32_t       mask;
+   __m256i        in;
+   __m256i        m;
+
+   const __m256i  lt    = _mm256_set1_epi8('<');
+   const __m256i  gt    = _mm256_set1_epi8('>');
+   const __m256i  amp   = _mm256_set1_epi8('&');
+   const __m256i  quot  = _mm256_set1_epi8('"');
+   const __m256i  apos  = _mm256_set1_epi8('\'');
+
+   for(pos = 0; ((n - pos) >= 32); pos += 32)
+   {  in    = _mm256_loadu_si256((const __m256i *)&src[pos]);
+      m     = _mm256_or_si256(_mm256_cmpeq_epi8(in, lt), _mm256_cmpeq_epi8(in, gt));
+      m     = _mm256_or_si256(m, _mm256_cmpeq_epi8(in, amp));
+      m     = _mm256_or_si256(m, _mm256_cmpeq_epi8(in, quot));
+      m     = _mm256_or_si256(m, _mm256_cmpeq_epi8(in, apos));
+      if ((mask = (uint32_t)_mm256_movemask_epi8(m)) != 0)
+         return(pos + (size_t)__builtin_ctz(mask));
+   };
+
+   return(pos + my_xml_escape_span_sse2(&src[pos], (n - pos)));
+}
+#endif
+
+
+size_t
+my_xml_escape_span_scalar(
+         const uint8_t *               src,
+         size_t                        n )
+{
+   size_t         pos;
+   for(pos = 0; (pos < n); pos++)
+   {  switch(src[pos])
+      {  case '<':
+         case '>':
+         case '&':
+         case '"':
+         case '\'':
+            return(pos);
+
+         default:
+            break;
+      };
+   };
+   return(n);
+}
+
+
+#ifdef MY_USE_X86_SIMD
+__attribute__((target("sse2")))
+size_t
+my_xml_escape_span_sse2(
+         const uint8_t *               src,
+         size_t                        n )
+{
+   size_t         pos;
+   uint32_t       mask;
+   __m128i        in;
+   __m128i        m;
+
+   const __m128i  lt    = _mm_set1_epi8('<');
+   const __m128i  gt    = _mm_set1_epi8('>');
+   const __m128i  amp   = _mm_set1_epi8('&');
+   const __m128i  quot  = _mm_set1_epi8('"');
+   const __m128i  apos  = _mm_set1_epi8('\'');
+
+   for(pos = 0; ((n - pos) >= 16); pos += 16)
+   {  in    = _mm_loadu_si128((const __m128i *)&src[pos]);
+      m     = _mm_or_si128(_mm_cmpeq_epi8(in, lt), _mm_cmpeq_epi8(in, gt));
+      m     = _mm_or_si128(m, _mm_cmpeq_epi8(in, amp));
+      m     = _mm_or_si128(m, _mm_cmpeq_epi8(in, quot));
+      m     = _mm_or_si128(m, _mm_cmpeq_epi8(in, apos));
+      if ((mask = (uint32_t)_mm_movemask_epi8(m)) != 0)
+         return(pos + (size_t)__builtin_ctz(mask));
+   };
+
+   return(pos + my_xml_escape_span_scalar(&src[pos], (n - pos)));
+}
+#endif
+
+
 /* end of source */
@@ -0,0 +1,593 @@
+/*
+ *  Davici Utilities for Strongswan
+ *  Copyright (C) 2026 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __SRC_DAVICICTL_OUTPUT_C 1
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include "davicictl.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <sys/uio.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#define MY_OUT_FLAGS          (O_WRONLY | O_CREAT | O_APPEND)
+
+
+//////////////
+//          //
+//  Macros  //
+//          //
+//////////////
+// MARK: - Macros
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+#pragma mark - Datatypes
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static int
+my_out_writev(
+         my_config_t *                 cnf,
+         struct iovec *                iov,
+         int                           iovcnt );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+// MARK: - Variables
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+my_out_base64(
+         my_config_t *                 cnf,
+         const void *                  src,
+         size_t                        n )
+{
+   int               rc;
+   size_t            len;
+   size_t            chunk;
+   const uint8_t *   ptr;
+
+   ptr   = src;
+   chunk = ((cnf->out.size - 1) / 4) * 3;
+   chunk = (chunk < MY_BASE64_CHUNK) ? chunk : MY_BASE64_CHUNK;
+
+   // encode directly into output buffer in fixed size chunks
+   while (n > 0)
+   {  len = (n < chunk) ? n : chunk;
+      if ((cnf->out.size - cnf->out.len) <= MY_BASE64_LEN(len))
+         if ((rc = my_out_flush(cnf)) < 0)
+            return(rc);
+      if ((rc = my_base64_encode(&cnf->out.data[cnf->out.len], (cnf->out.size - cnf->out.len), ptr, len)) < 0)
+         return(rc);
+      cnf->out.len  += (size_t)rc;
+      ptr           += len;
+      n             -= len;
+   };
+
+   return(0);
+}
+
+
+int
+my_out_xml(
+         my_config_t *                 cnf,
+         const void *                  src,
+         size_t                        n )
+{
+   int               rc;
+   size_t            span;
+   const uint8_t *   ptr;
+
+   ptr = src;
+
+   while (n > 0)
+   {  // copy runs of characters which do not require escaping
+      if ((span = my_xml_escape_span(ptr, n)) > 0)
+      {  if ((rc = my_out_write(cnf, ptr, span)) < 0)
+            return(rc);
+         ptr   += span;
+         n     -= span;
+         if (!(n))
+            break;
+      };
+
+      switch(*ptr)
+      {  case '<':  rc = my_out_write(cnf, "&lt;",   4); break;
+         case '>':  rc = my_out_write(cnf, "&gt;",   4); break;
+         case '&':  rc = my_out_write(cnf, "&amp;",  5); break;
+         case '"':  rc = my_out_write(cnf, "&quot;", 6); break;
+         default:   rc = my_out_write(cnf, "&apos;", 6); break;
+      };
+      if (rc < 0)
+         return(rc);
+      ptr++;
+      n--;
+   };
+
+   return(0);
+}
+
+
+int
+my_out_xml_value(
+         my_config_t *                 cnf,
+         const my_value_t *            val )
+{
+   if ((val->is_binary))
+      return(my_out_base64(cnf, val->data, val->len));
+   return(my_out_xml(cnf, val->data, val->len));
+}
+
+
+int
+my_out_delim(
+         my_config_t *                 cnf,
+         int                           delim,
+         unsigned                      level )
+{
+   int               rc;
+   size_t            width;
+   const char *      ptr;
+
+   // delimiter and indentation are copied as a single run of the slab,
+   // the delimiter is the trailing `delim' bytes of the leading ",\n"
+   ptr   = &cnf->out_slab[2 - delim];
+   width = (size_t)level * cnf->out_indent;
+   if (width <= MY_OUT_SLAB_SIZE)
+      return(my_out_write(cnf, ptr, ((size_t)delim + width)));
+
+   if ((rc = my_out_write(cnf, ptr, (size_t)delim)) < 0)
+      return(rc);
+   return(my_out_indent(cnf, width));
+}
+
+
+int
+my_out_flush(
+         my_config_t *                 cnf )
+{
+   struct iovec      iov;
+
+   if (!(cnf->out.len))
+      return(cnf->out_err);
+
+   iov.iov_base   = cnf->out.data;
+   iov.iov_len    = cnf->out.len;
+   cnf->out.len   = 0;
+
+   return(my_out_writev(cnf, &iov, 1));
+}
+
+
+void
+my_out_free(
+         my_config_t *                 cnf )
+{
+   if (!(cnf))
+      return;
+   my_out_flush(cnf);
+   my_writer_stop(cnf);
+   if ( ((cnf->opt_output)) && (cnf->out_fd > STDERR_FILENO) )
+      close(cnf->out_fd);
+   free(cnf->out.data);
+   free(cnf->out_slab);
+   memset(&cnf->out, 0, sizeof(my_buffer_t));
+   cnf->out_slab = NULL;
+   return;
+}
+
+
+int
+my_out_indent(
+         my_config_t *                 cnf,
+         size_t                        width )
+{
+   int               rc;
+
+   if ((cnf->out.size - cnf->out.len) < width)
+   {  if ((rc = my_out_flush(cnf)) < 0)
+         return(rc);
+      while (width > cnf->out.size)
+      {  memset(cnf->out.data, ' ', cnf->out.size);
+         cnf->out.len   = cnf->out.size;
+         width         -= cnf->out.size;
+         if ((rc = my_out_flush(cnf)) < 0)
+            return(rc);
+      };
+   };
+
+   memset(&cnf->out.data[cnf->out.len], ' ', width);
+   cnf->out.len += width;
+
+   return(0);
+}
+
+
+int
+my_out_init(
+         my_config_t *                 cnf )
+{
+   size_t            size;
+
+   assert(cnf != NULL);
+
+   size = ((cnf->out_threshold)) ? cnf->out_threshold : MY_OUT_BUFF_SIZE;
+
+   if ((cnf->out.data = malloc(size)) == NULL)
+   {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      return(-ENOMEM);
+   };
+   cnf->out.size  = size;
+   cnf->out.len   = 0;
+   cnf->out_fd    = STDOUT_FILENO;
+
+   // output file is appended to so it may be rotated while open
+   if ((cnf->opt_output))
+   {  if ((cnf->out_fd = open(cnf->opt_output, MY_OUT_FLAGS, 0644)) == -1)
+      {  cnf->out_fd = STDOUT_FILENO;
+         fprintf(stderr, "%s: %s: %s\n", my_prog_name(cnf), cnf->opt_output, strerror(errno));
+         return(-1);
+      };
+   };
+
+   // slab of pretty printing delimiters followed by indentation
+   if ((cnf->out_slab = malloc(MY_OUT_SLAB_SIZE + 2)) == NULL)
+   {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      return(-ENOMEM);
+   };
+   cnf->out_slab[0]  = ',';
+   cnf->out_slab[1]  = '\n';
+   memset(&cnf->out_slab[2], ' ', MY_OUT_SLAB_SIZE);
+   cnf->out_indent   = ((cnf->out_indent)) ? cnf->out_indent : MY_OUT_INDENT;
+
+   return(my_writer_start(cnf));
+}
+
+
+int
+my_out_json(
+         my_config_t *                 cnf,
+         const void *                  src,
+         size_t                        n )
+{
+   int               rc;
+   size_t            span;
+   const uint8_t *   ptr;
+
+   ptr = src;
+
+   while (n > 0)
+   {  // copy runs of characters which do not require escaping
+      if ((span = my_json_escape_span(ptr, n)) > 0)
+      {  if ((rc = my_out_write(cnf, ptr, span)) < 0)
+            return(rc);
+         ptr   += span;
+         n     -= span;
+         if (!(n))
+            break;
+      };
+
+      switch(*ptr)
+      {  case '"':  rc = my_out_write(cnf, "\\\"", 2); break;
+         case '\\': rc = my_out_write(cnf, "\\\\", 2); break;
+         case '\b': rc = my_out_write(cnf, "\\b", 2); break;
+         case '\f': rc = my_out_write(cnf, "\\f", 2); break;
+         case '\n': rc = my_out_write(cnf, "\\n", 2); break;
+         case '\r': rc = my_out_write(cnf, "\\r", 2); break;
+         case '\t': rc = my_out_write(cnf, "\\t", 2); break;
+         default:   rc = my_out_printf(cnf, "\\u%04x", (unsigned)*ptr); break;
+      };
+      if (rc < 0)
+         return(rc);
+      ptr++;
+      n--;
+   };
+
+   return(0);
+}
+
+
+int
+my_out_json_value(
+         my_config_t *                 cnf,
+         const my_value_t *            val )
+{
+   if ((val->is_binary))
+      return(my_out_base64(cnf, val->data, val->len));
+   return(my_out_json(cnf, val->data, val->len));
+}
+
+
+int
+my_out_printf(
+         my_config_t *                 cnf,
+         const char *                  fmt,
+         ... )
+{
+   int               rc;
+   int               len;
+   char *            str;
+   va_list           args;
+
+   // attempt to format directly into the buffer
+   va_start(args, fmt);
+   len = vsnprintf(&cnf->out.data[cnf->out.len], (cnf->out.size - cnf->out.len), fmt, args);
+   va_end(args);
+   if (len < 0)
+      return(-EINVAL);
+   if ((size_t)len < (cnf->out.size - cnf->out.len))
+   {  cnf->out.len += (size_t)len;
+      return(0);
+   };
+
+   // flush buffer and retry if output did not fit
+   if ((rc = my_out_flush(cnf)) < 0)
+      return(rc);
+
+   // lines larger than the buffer are formatted separately and written
+   // directly, the same as large values
+   if ((size_t)len >= cnf->out.size)
+   {  if ((str = malloc((size_t)len + 1)) == NULL)
+         return(-ENOMEM);
+      va_start(args, fmt);
+      vsnprintf(str, ((size_t)len + 1), fmt, args);
+      va_end(args);
+      rc = my_out_write(cnf, str, (size_t)len);
+      free(str);
+      return(rc);
+   };
+
+   va_start(args, fmt);
+   vsnprintf(cnf->out.data, cnf->out.size, fmt, args);
+   va_end(args);
+   cnf->out.len = (size_t)len;
+
+   return(0);
+}
+
+
+int
+my_out_putc(
+         my_config_t *                 cnf,
+         int                           c )
+{
+   int               rc;
+
+   if (cnf->out.len == cnf->out.size)
+      if ((rc = my_out_flush(cnf)) < 0)
+         return(rc);
+
+   cnf->out.data[cnf->out.len++] = (char)c;
+
+   return(0);
+}
+
+
+int
+my_out_puts(
+         my_config_t *                 cnf,
+         const char *                  str )
+{
+   return(my_out_write(cnf, str, strlen(str)));
+}
+
+
+int
+my_out_reopen(
+         my_config_t *                 cnf )
+{
+   int               fd;
+   int               rc;
+
+   if (!(cnf->opt_output))
+      return(0);
+
+   // buffered output belongs to the previous file
+   if ((rc = my_out_flush(cnf)) < 0)
+      return(rc);
+
+   // replace descriptor in place so the writer thread follows the new file
+   if ((fd = open(cnf->opt_output, MY_OUT_FLAGS, 0644)) == -1)
+   {  rc = -errno;
+      fprintf(stderr, "%s: %s: %s\n", my_prog_name(cnf), cnf->opt_output, strerror(errno));
+      return(rc);
+   };
+   if (dup2(fd, cnf->out_fd) == -1)
+   {  rc = -errno;
+      fprintf(stderr, "%s: dup2(): %s\n", my_prog_name(cnf), strerror(errno));
+      close(fd);
+      return(rc);
+   };
+   close(fd);
+
+   return(0);
+}
+
+
+int
+my_out_value(
+         my_config_t *                 cnf,
+         const my_value_t *            val )
+{
+   if ((val->is_binary))
+      return(my_out_base64(cnf, val->data, val->len));
+   return(my_out_write(cnf, val->data, val->len));
+}
+
+
+int
+my_out_write(
+         my_config_t *                 cnf,
+         const void *                  ptr,
+         size_t                        len )
+{
+   int               rc;
+   struct iovec      iov[2];
+
+   // append to buffer if space is available
+   if (len <= (cnf->out.size - cnf->out.len))
+   {  memcpy(&cnf->out.data[cnf->out.len], ptr, len);
+      cnf->out.len += len;
+      return(0);
+   };
+
+   // values larger than the buffer are written along with the pending
+   // buffer in a single system call instead of being copied
+   if (len >= cnf->out.size)
+   {  iov[0].iov_base   = cnf->out.data;
+      iov[0].iov_len    = cnf->out.len;
+      iov[1].iov_base   = (void *)(uintptr_t)ptr;
+      iov[1].iov_len    = len;
+      cnf->out.len      = 0;
+      return(my_out_writev(cnf, iov, 2));
+   };
+
+   if ((rc = my_out_flush(cnf)) < 0)
+      return(rc);
+   memcpy(cnf->out.data, ptr, len);
+   cnf->out.len = len;
+
+   return(0);
+}
+
+
+int
+my_out_writev(
+         my_config_t *                 cnf,
+         struct iovec *                iov,
+         int                           iovcnt )
+{
+   int               pos;
+   ssize_t           rc;
+   size_t            len;
+   void *            ptr;
+
+   // discard output after an unrecoverable write error
+   if ((cnf->out_err))
+      return(cnf->out_err);
+
+   // append output to capture buffer instead of writing to descriptor
+   if ((cnf->out_capture))
+   {  for(; (iovcnt > 0); iov++, iovcnt--)
+      {  if ((ptr = my_buffer_alloc(cnf->out_capture, iov->iov_len)) == NULL)
+            return(-ENOMEM);
+         memcpy(ptr, iov->iov_base, iov->iov_len);
+      };
+      return(0);
+   };
+
+   for(pos = 0; (pos < iovcnt); pos++)
+      cnf->stats.bytes += iov[pos].iov_len;
+
+   // queue output for writer thread
+   if ((cnf->writer))
+   {  if ((rc = my_writer_writev(cnf, iov, iovcnt)) < 0)
+      {  cnf->out_err = (int)rc;
+         fprintf(stderr, "%s: write(): %s\n", my_prog_name(cnf), strerror((int)-rc));
+      };
+      return((int)rc);
+   };
+
+   while (iovcnt > 0)
+   {  // skip empty vectors
+      if (!(iov->iov_len))
+      {  iov++;
+         iovcnt--;
+         continue;
+      };
+
+      if ((rc = writev(cnf->out_fd, iov, iovcnt)) < 0)
+      {  if (errno == EINTR)
+            continue;
+         cnf->out_err = -errno;
+         fprintf(stderr, "%s: writev(): %s\n", my_prog_name(cnf), strerror(errno));
+         return(cnf->out_err);
+      };
+
+      // advance past data written by partial writes
+      for(len = (size_t)rc; ( (iovcnt > 0) && (len >= iov->iov_len) ); iov++, iovcnt--)
+         len -= iov->iov_len;
+      if (iovcnt > 0)
+      {  iov->iov_base  = &((char *)iov->iov_base)[len];
+         iov->iov_len  -= len;
+      };
+   };
+
+   return(0);
+}
+
+
+/* end of source */
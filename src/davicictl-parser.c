@@ -65,8 +65,23 @@
 ///////////////////
 // MARK: - Definitions
 
-#undef   MY_SECTS_MAX_DEPTH
-#define  MY_SECTS_MAX_DEPTH      128
+#undef   MY_PARSE_EMIT
+#define  MY_PARSE_EMIT        0
+#undef   MY_PARSE_PENDING
+#define  MY_PARSE_PENDING     1
+#undef   MY_PARSE_DROP
+#define  MY_PARSE_DROP        1
+
+#undef   MY_PARSE_TAG_NONE
+#define  MY_PARSE_TAG_NONE    0
+#undef   MY_PARSE_TAG_MESSAGE
+#define  MY_PARSE_TAG_MESSAGE 1
+#undef   MY_PARSE_TAG_RECORD
+#define  MY_PARSE_TAG_RECORD  2
+#undef   MY_PARSE_TAG_SECTION
+#define  MY_PARSE_TAG_SECTION 3
+#undef   MY_PARSE_TAG_KEY
+#define  MY_PARSE_TAG_KEY     "socket"
 
 
 //////////////
@@ -84,6 +99,34 @@
 /////////////////
 #pragma mark - Datatypes
 
+typedef struct _my_cursor     my_cursor_t;
+typedef struct _my_tape       my_tape_t;
+
+
+struct _my_cursor
+{  struct davici_response *      res;
+   const my_buffer_t *           tape;
+   const my_buffer_t *           tape_data;
+   const my_tape_t *             elem;
+   size_t                        pos;
+   const char *                  tag;
+   int                           tag_mode;
+   int                           pending;
+   int                           closing;
+   int                           synthetic;
+   unsigned                      shift;
+};
+
+
+struct _my_tape
+{  int                           type;
+   int                           is_binary;
+   unsigned                      level;
+   size_t                        name;
+   size_t                        data;
+   size_t                        len;
+};
+
 
 //////////////////
 //              //
@@ -92,132 +135,125 @@
 //////////////////
 // MARK: - Prototypes
 
-//-------------------------//
-// debug format prototypes //
-//-------------------------//
-#pragma mark debug format prototypes
-
 static int
-my_parse_res_debug(
-         const char *                  name,
-         struct davici_response *      res,
-         my_config_t *                 cnf,
-         int                           is_event );
+my_get_value(
+         my_cursor_t *                 cur,
+         my_value_t *                  val );
 
 
-static int
-my_parse_res_debug_print(
-         unsigned                      level,
-         const char *                  name,
-         const char *                  key,
-         const char *                  val );
+static const char *
+my_parse_data(
+         my_cursor_t *                 cur,
+         unsigned *                    lenp );
 
 
 static int
-my_get_value(
-         struct davici_response *      res,
-         char *                        buff,
-         size_t                        buff_len,
-         int *                         is_string );
-
+my_parse_decide(
+         my_config_t *                 cnf,
+         const my_emitter_t *          emitter,
+         const char *                  name,
+         int                           is_event,
+         int                           is_record,
+         int                           result,
+         int *                         startedp,
+         unsigned *                    skipp );
 
-//------------------------//
-// json format prototypes //
-//------------------------//
-#pragma mark json format prototypes
 
 static int
-my_parse_footer_json(
-         my_config_t *                 cnf );
+my_parse_dispatch(
+         my_config_t *                 cnf,
+         const my_emitter_t *          emitter,
+         int                           type,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val );
 
 
 static int
-my_parse_res_json(
-         const char *                  name,
-         struct davici_response *      res,
+my_parse_emit(
          my_config_t *                 cnf,
-         int                           is_event );
+         const my_emitter_t *          emitter,
+         int                           type,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val );
 
 
 static int
-my_parse_res_json_delim(
+my_parse_elems(
          my_config_t *                 cnf,
-         int                           level );
+         const my_emitter_t *          emitter,
+         const char *                  name,
+         my_cursor_t *                 cur,
+         int                           is_event );
 
 
-//------------------------//
-// vici format prototypes //
-//------------------------//
-#pragma mark vici format prototypes
+static unsigned
+my_parse_level(
+         my_cursor_t *                 cur );
+
 
 static int
-my_parse_res_vici(
-         const char *                  name,
-         struct davici_response *      res,
+my_parse_msg_start(
          my_config_t *                 cnf,
+         const my_emitter_t *          emitter,
+         const char *                  name,
          int                           is_event );
 
 
-static int
-my_parse_res_vici_delim(
-         my_config_t *                 cnf,
-         int                           level );
-
+static const char *
+my_parse_name(
+         my_cursor_t *                 cur );
 
-//-----------------------//
-// xml format prototypes //
-//-----------------------//
-#pragma mark xml format prototypes
 
 static int
-my_parse_footer_xml(
+my_parse_next(
+         my_cursor_t *                 cur );
+
+
+static void
+my_parse_pop(
          my_config_t *                 cnf );
 
 
 static int
-my_parse_res_xml(
-         const char *                  name,
-         struct davici_response *      res,
+my_parse_push(
          my_config_t *                 cnf,
-         int                           is_event );
+         const char *                  name );
 
 
 static int
-my_parse_res_xml_delim(
+my_parse_replay(
          my_config_t *                 cnf,
-         int                           level );
-
-
-static void
-my_parse_res_xml_sect_free(
-         char **                       sections );
+         const my_emitter_t *          emitter,
+         int                           is_record,
+         unsigned *                    skipp );
 
 
 static int
-my_parse_res_xml_sect_set(
+my_parse_selected(
          my_config_t *                 cnf,
-         char **                       sects,
-         int                           level,
-         const char *                  sect );
+         const char *                  key,
+         int                           is_section );
+
 
+static void
+my_parse_unit(
+         my_config_t *                 cnf );
 
-//-----------------------//
-// yaml format prototypes //
-//-----------------------//
-#pragma mark yaml format prototypes
 
 static int
-my_parse_res_yaml(
-         const char *                  name,
-         struct davici_response *      res,
+my_parse_where_needs(
          my_config_t *                 cnf,
-         int                           is_event );
+         int                           prefix );
 
 
 static int
-my_parse_res_yaml_delim(
+my_parse_where_test(
          my_config_t *                 cnf,
-         int                           level );
+         const char *                  key,
+         const char *                  data,
+         size_t                        len );
 
 
 /////////////////
@@ -227,6 +263,23 @@ my_parse_res_yaml_delim(
 /////////////////
 // MARK: - Variables
 
+#pragma mark my_emitter_map[]
+static const my_emitter_t * const my_emitter_map[] =
+{  &my_emitter_arrow,
+   &my_emitter_cbor,
+   &my_emitter_csv,
+   &my_emitter_debug,
+   &my_emitter_json,
+   &my_emitter_msgpack,
+   &my_emitter_ndjson,
+   &my_emitter_openmetrics,
+   &my_emitter_tsv,
+   &my_emitter_vici,
+   &my_emitter_xml,
+   &my_emitter_yaml,
+   NULL
+};
+
 
 /////////////////
 //             //
@@ -236,158 +289,318 @@ my_parse_res_yaml_delim(
 // MARK: - Functions
 
 int
-my_parse_footer(
-         my_config_t *                 cnf )
+my_get_value(
+         my_cursor_t *                 cur,
+         my_value_t *                  val )
 {
-   if (!(cnf->res_last_name))
-      return(0);
+   unsigned int      len;
 
-   switch(cnf->format_out)
-   {  case MY_FMT_JSON:    return(my_parse_footer_json(cnf));
-      case MY_FMT_XML:     return(my_parse_footer_xml(cnf));
-      default:             break;
-   };
+   assert(val != NULL);
+
+   // retrieve value
+   if ((val->data = my_parse_data(cur, &len)) == NULL)
+      len = 0;
+   val->len       = len;
+
+   // values which are not printable UTF-8 text are encoded as base64
+   val->is_binary = ((my_utf8_is_text(val->data, val->len))) ? 0 : 1;
 
    return(0);
 }
 
 
+const char *
+my_parse_data(
+         my_cursor_t *                 cur,
+         unsigned *                    lenp )
+{
+   if ((cur->synthetic))
+   {  *lenp = (unsigned)strlen(cur->tag);
+      return(cur->tag);
+   };
+   if ((cur->res))
+      return(davici_get_value(cur->res, lenp));
+   *lenp = (unsigned)cur->elem->len;
+   return(&cur->tape_data->data[cur->elem->data]);
+}
+
+
 int
-my_parse_res(
-         const char *                  name,
-         struct davici_response *      res,
+my_parse_decide(
          my_config_t *                 cnf,
-         int                           is_event )
+         const my_emitter_t *          emitter,
+         const char *                  name,
+         int                           is_event,
+         int                           is_record,
+         int                           result,
+         int *                         startedp,
+         unsigned *                    skipp )
 {
-   switch(cnf->format_out)
-   {  case MY_FMT_DEBUG:   return(my_parse_res_debug(name, res, cnf, is_event));
-      case MY_FMT_JSON:    return(my_parse_res_json(name, res, cnf, is_event));
-      case MY_FMT_VICI:    return(my_parse_res_vici(name, res, cnf, is_event));
-      case MY_FMT_XML:     return(my_parse_res_xml(name, res, cnf, is_event));
-      case MY_FMT_YAML:    return(my_parse_res_yaml(name, res, cnf, is_event));
-      default:             break;
+   int               rc;
+   unsigned          skip;
+   size_t            depth;
+
+   cnf->where_state = MY_PARSE_EMIT;
+
+   if (result < 0)
+   {  // discard recorded elements of unit which does not match
+      cnf->tape.len        = 0;
+      cnf->tape_data.len   = 0;
+      if (!(is_record))
+         return(MY_PARSE_DROP);
+      skip = 1;
+   } else
+   {  // emit recorded elements of unit which matches and continue live,
+      // the message is started with the first unit which matches
+      if ( (!(*startedp)) && ((rc = my_parse_msg_start(cnf, emitter, name, is_event)) < 0) )
+         return(rc);
+      *startedp = 1;
+      if ((rc = my_parse_replay(cnf, emitter, is_record, &skip)) < 0)
+         return(rc);
+      if (!(skip))
+         return(0);
    };
-   cnf->flags |= MY_FLG_PRETTY;
-   return(my_parse_res_vici(name, res, cnf, is_event));
+
+   // leave the subtree which is skipped by the parser
+   depth = ((skip - 1) > (unsigned)is_record) ? (skip - 1 - is_record) : 0;
+   while((cnf->path_offs.len / sizeof(size_t)) > depth)
+      my_parse_pop(cnf);
+   *skipp = skip;
+
+   return(0);
 }
 
 
 int
-my_get_value(
-         struct davici_response *      res,
-         char *                        buff,
-         size_t                        buff_len,
-         int *                         is_string )
+my_parse_dispatch(
+         my_config_t *                 cnf,
+         const my_emitter_t *          emitter,
+         int                           type,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val )
 {
-   size_t            c;
-   int               inval;
-   const char *      ptr;
-   unsigned int      ptr_len;
+   switch(type)
+   {  case DAVICI_SECTION_START:
+         return( ((emitter->func_sect_start)) ? emitter->func_sect_start(cnf, level, key) : 0 );
 
-   assert(buff != NULL);
-   assert(buff_len > 2);
+      case DAVICI_SECTION_END:
+         return( ((emitter->func_sect_end)) ? emitter->func_sect_end(cnf, level) : 0 );
 
-   inval = 0;
+      case DAVICI_KEY_VALUE:
+         return( ((emitter->func_key_value)) ? emitter->func_key_value(cnf, level, key, val) : 0 );
 
-   // retrieve value
-   if ((ptr = davici_get_value(res, &ptr_len)) == NULL)
-   {  buff[0] = '\0';
-      return(0);
-   };
-   if (buff_len <= (size_t)(ptr_len+1))
-      return(-ENOBUFS);
-
-   // copy to buffer as string
-   for(c = 0; ((c < ptr_len) && (!(inval))); c++)
-      if (!(isprint(buff[c] = ptr[c])))
-         inval = 1;
-   if (!(inval))
-   {  buff[c] = '\0';
-      if ((is_string))
-         *is_string = 1;
-      return(0);
+      case DAVICI_LIST_START:
+         return( ((emitter->func_list_start)) ? emitter->func_list_start(cnf, level, key) : 0 );
+
+      case DAVICI_LIST_ITEM:
+         return( ((emitter->func_list_item)) ? emitter->func_list_item(cnf, level, val) : 0 );
+
+      case DAVICI_LIST_END:
+         return( ((emitter->func_list_end)) ? emitter->func_list_end(cnf, level) : 0 );
+
+      default:
+         break;
    };
 
-   // encode value as base64 string
-   return(my_base64_encode(buff, buff_len, (const uint8_t *)ptr, ptr_len));
+   return(0);
 }
 
 
-//------------------------//
-// debug format functions //
-//------------------------//
-#pragma mark debug format functions
-
 int
-my_parse_res_debug(
-         const char *                  name,
-         struct davici_response *      res,
+my_parse_elems(
          my_config_t *                 cnf,
+         const my_emitter_t *          emitter,
+         const char *                  name,
+         my_cursor_t *                 cur,
          int                           is_event )
 {
-   int               rc;
-   char              val[4096];
-   const char *      key;
-   unsigned          level;
-   char              title[64];
-
-   if (!(cnf))
-      return(0);
+   int                     rc;
+   int                     is_record;
+   int                     is_started;
+   int                     result;
+   my_value_t              val;
+   unsigned                level;
+   unsigned                skip;
+   unsigned int            len;
+   const char *            key;
+   const char *            data;
+
+   // messages received from multiple sockets are tagged with the path of
+   // the socket, either as key of each message or record, or as the name
+   // of a row containing the message. Emitters merging messages nest the
+   // replies of each socket in a section named after the socket instead.
+   if ( ((cnf->sock)) && ( ((cnf->widget->flags & MY_FLG_STREAM)) || (!(emitter->flags & MY_EMIT_MERGE)) ) )
+   {  cur->tag = cnf->sock->path;
+      if ((cnf->widget->flags & MY_FLG_RECORDS))
+      {  cur->tag_mode  = MY_PARSE_TAG_RECORD;
+      } else if ( ((cnf->widget->flags & MY_FLG_STREAM)) || (!(emitter->flags & MY_EMIT_ROWS)) )
+      {  cur->tag_mode  = MY_PARSE_TAG_MESSAGE;
+         cur->pending   = DAVICI_KEY_VALUE;
+      } else
+      {  cur->tag_mode  = MY_PARSE_TAG_SECTION;
+         cur->pending   = DAVICI_SECTION_START;
+      };
+   };
 
-   my_strlcpy(title, "VICI ", sizeof(title));
-   my_strlcat(title, (((is_event)) ? "Event" : "Reply"), sizeof(title));
-   my_parse_res_debug_print(0, title, name, NULL);
+   level                = my_parse_level(cur) + 1;
+   skip                 = 0;
+   is_record            = ( ((cnf->flags & MY_FLG_RECORDS)) || ( ((cnf->widget)) && ((cnf->widget->flags & MY_FLG_RECORDS)) ) ) ? 1 : 0;
+   cnf->path.len        = 0;
+   cnf->path_offs.len   = 0;
+   cnf->select_depth    = 0;
+   cnf->hide_depth      = 0;
+   cnf->where_state     = MY_PARSE_EMIT;
+
+   // messages are emitted once they are known to match the where
+   // predicates, the top level sections of record widgets are matched
+   // individually and the message is omitted if no record matches
+   is_started           = 0;
+   if ((cnf->where_len))
+   {  if (!(is_record))
+         my_parse_unit(cnf);
+   } else
+   {  if ((rc = my_parse_msg_start(cnf, emitter, name, is_event)) < 0)
+         return(rc);
+      is_started = 1;
+   };
 
-   level = davici_get_level(res)+1;
+   // pass each element of the message to the emitter; closing elements
+   // are reported at the level of the element being closed. Paths of
+   // elements are relative to the top level sections of record widgets.
+   while((rc = my_parse_next(cur)) >= 0)
+   {  // elements of a subtree declined by the emitter are not decoded
+      if ((skip))
+      {  if ( ((rc == DAVICI_SECTION_END) || (rc == DAVICI_LIST_END)) && ((level-1) == skip) )
+            skip = 0;
+         level = my_parse_level(cur) + 1;
+         continue;
+      };
 
-   while((rc = davici_parse(res)) >= 0)
-   {  switch(rc)
+      result = 0;
+      switch(rc)
       {  case DAVICI_END:
-            my_parse_res_debug_print(level-1, "DAVICI_END", NULL, NULL);
-            return(0);
+            // message did not satisfy the where predicates
+            if (!(is_started))
+               return(0);
+            rc = ((emitter->func_msg_end)) ? emitter->func_msg_end(cnf, level-1, name, is_event) : 0;
+            return((rc < 0) ? rc : 0);
 
          case DAVICI_SECTION_START:
-            key = davici_get_name(res);
-            my_parse_res_debug_print(level, "DAVICI_SECTION_START", key, NULL);
+            key = my_parse_name(cur);
+            if ( ((is_record)) && (level == 1) )
+            {  if ((cnf->where_len))
+                  my_parse_unit(cnf);
+               rc    = my_parse_emit(cnf, emitter, DAVICI_SECTION_START, level, key, NULL);
+               skip  = (rc == MY_EMIT_SKIP) ? level : 0;
+               // name of record is matched as key `name'
+               if (cnf->where_state == MY_PARSE_PENDING)
+                  result = my_parse_where_test(cnf, "name", key, strlen(key));
+               break;
+            };
+            if ((rc = my_parse_push(cnf, key)) < 0)
+               return(rc);
+            if ((cnf->hide_depth))
+               rc = ((my_parse_where_needs(cnf, 1))) ? 0 : MY_EMIT_SKIP;
+            else if ((my_parse_selected(cnf, NULL, 1)))
+               rc = my_parse_emit(cnf, emitter, DAVICI_SECTION_START, level, key, NULL);
+            else if ((my_parse_where_needs(cnf, 1)))
+               cnf->hide_depth = cnf->path_offs.len / sizeof(size_t);
+            else
+               rc = MY_EMIT_SKIP;
+            if (rc == MY_EMIT_SKIP)
+            {  my_parse_pop(cnf);
+               skip = level;
+            };
             break;
 
          case DAVICI_SECTION_END:
-            my_parse_res_debug_print(level, "DAVICI_SECTION_END", NULL, NULL);
+            if ( ((is_record)) && ((level-1) == 1) )
+            {  if (cnf->where_state != MY_PARSE_PENDING)
+               {  rc = my_parse_emit(cnf, emitter, DAVICI_SECTION_END, level-1, NULL, NULL);
+                  break;
+               };
+               // discard record which did not satisfy the where predicates
+               cnf->tape.len        = 0;
+               cnf->tape_data.len   = 0;
+               cnf->where_state     = MY_PARSE_EMIT;
+               rc                   = 0;
+               break;
+            };
+            rc = (!(cnf->hide_depth)) ? my_parse_emit(cnf, emitter, DAVICI_SECTION_END, level-1, NULL, NULL) : 0;
+            my_parse_pop(cnf);
             break;
 
          case DAVICI_KEY_VALUE:
-            rc = my_get_value(res, val, sizeof(val), NULL);
-            if (rc < 0)
+            key = my_parse_name(cur);
+            if (cnf->where_state == MY_PARSE_PENDING)
+            {  data     = my_parse_data(cur, &len);
+               result   = my_parse_where_test(cnf, key, data, ((data)) ? len : 0);
+            };
+            if ( ((cnf->hide_depth)) || (!(my_parse_selected(cnf, key, 0))) )
+            {  rc = 0;
+               break;
+            };
+            if ((rc = my_get_value(cur, &val)) < 0)
             {  fprintf(stderr, "%s: my_get_value(): %s\n", PROGRAM_NAME, strerror(-rc));
                return(rc);
             };
-            key = davici_get_name(res);
-            my_parse_res_debug_print(level, "DAVICI_KEY_VALUE", key, val);
+            rc = my_parse_emit(cnf, emitter, DAVICI_KEY_VALUE, level, key, &val);
             break;
 
          case DAVICI_LIST_START:
-            key = davici_get_name(res);
-            my_parse_res_debug_print(level, "DAVICI_LIST_START", key, NULL);
+            key = my_parse_name(cur);
+            if ((rc = my_parse_push(cnf, key)) < 0)
+               return(rc);
+            if ((cnf->hide_depth))
+               rc = ((my_parse_where_needs(cnf, 0))) ? 0 : MY_EMIT_SKIP;
+            else if ((my_parse_selected(cnf, NULL, 0)))
+               rc = my_parse_emit(cnf, emitter, DAVICI_LIST_START, level, key, NULL);
+            else if ((my_parse_where_needs(cnf, 0)))
+               cnf->hide_depth = cnf->path_offs.len / sizeof(size_t);
+            else
+               rc = MY_EMIT_SKIP;
+            if (rc == MY_EMIT_SKIP)
+            {  my_parse_pop(cnf);
+               skip = level;
+            };
             break;
 
          case DAVICI_LIST_ITEM:
-            rc = my_get_value(res, val, sizeof(val), NULL);
-            if (rc < 0)
+            if (cnf->where_state == MY_PARSE_PENDING)
+            {  data     = my_parse_data(cur, &len);
+               result   = my_parse_where_test(cnf, NULL, data, ((data)) ? len : 0);
+            };
+            if ((cnf->hide_depth))
+            {  rc = 0;
+               break;
+            };
+            if ((rc = my_get_value(cur, &val)) < 0)
             {  fprintf(stderr, "%s: my_get_value(): %s\n", PROGRAM_NAME, strerror(-rc));
                return(rc);
             };
-            my_parse_res_debug_print(level, "DAVICI_LIST_ITEM", val, NULL);
+            rc = my_parse_emit(cnf, emitter, DAVICI_LIST_ITEM, level, NULL, &val);
             break;
 
          case DAVICI_LIST_END:
-            my_parse_res_debug_print(level, "DAVICI_LIST_END", NULL, NULL);
+            rc = (!(cnf->hide_depth)) ? my_parse_emit(cnf, emitter, DAVICI_LIST_END, level-1, NULL, NULL) : 0;
+            my_parse_pop(cnf);
             break;
 
          default:
-            my_parse_res_debug_print(level, "UNKNOWN", NULL, NULL);
+            rc = 0;
             break;
       };
-      level = davici_get_level(res)+1;
+      if (rc < 0)
+         return(rc);
+
+      // unit is emitted or discarded once the where predicates are decided
+      if ((result))
+      {  if ((rc = my_parse_decide(cnf, emitter, name, is_event, is_record, result, &is_started, &skip)) != 0)
+            return((rc < 0) ? rc : 0);
+      };
+
+      level = my_parse_level(cur) + 1;
    };
 
    return(rc);
@@ -395,159 +608,276 @@ my_parse_res_debug(
 
 
 int
-my_parse_res_debug_print(
+my_parse_emit(
+         my_config_t *                 cnf,
+         const my_emitter_t *          emitter,
+         int                           type,
          unsigned                      level,
-         const char *                  name,
          const char *                  key,
-         const char *                  val )
+         const my_value_t *            val )
 {
-   char buff[64];
-
-   my_strlcpy(buff, name,  sizeof(buff));
-   my_strlcat(buff, ":",   sizeof(buff));
+   size_t            len;
+   char *            ptr;
+   my_tape_t *       elem;
+
+   if (cnf->where_state != MY_PARSE_PENDING)
+      return(my_parse_dispatch(cnf, emitter, type, level, key, val));
+
+   // record element until it is known whether the unit matches
+   if ((elem = (my_tape_t *)my_buffer_alloc(&cnf->tape, sizeof(my_tape_t))) == NULL)
+      return(-ENOMEM);
+   memset(elem, 0, sizeof(my_tape_t));
+   elem->type  = type;
+   elem->level = level;
+   if ((key))
+   {  len         = strlen(key) + 1;
+      elem->name  = cnf->tape_data.len + 1;
+      if ((ptr = my_buffer_alloc(&cnf->tape_data, len)) == NULL)
+         return(-ENOMEM);
+      memcpy(ptr, key, len);
+   };
+   if ((val))
+   {  elem->data        = cnf->tape_data.len;
+      elem->len         = val->len;
+      elem->is_binary   = val->is_binary;
+      if ((ptr = my_buffer_alloc(&cnf->tape_data, val->len)) == NULL)
+         return(-ENOMEM);
+      if ((val->len))
+         memcpy(ptr, val->data, val->len);
+   };
 
-   if (!(key))
-      return(printf("%s\n", buff));
-   if (!(val))
-      return(printf("%-24s%*s%s\n", buff, (level*3), "", key));
-   return(printf("%-24s%*s%s = \"%s\"\n", buff, (level*3), "", key, val));
+   return(0);
 }
 
 
-//-----------------------//
-// json format functions //
-//-----------------------//
-#pragma mark json format functions
+const my_emitter_t *
+my_parse_emitter(
+         my_config_t *                 cnf )
+{
+   int               pos;
+
+   if ((cnf->emitter))
+      return(cnf->emitter);
+
+   for(pos = 0; ((my_emitter_map[pos])); pos++)
+      if (my_emitter_map[pos]->format == cnf->format_out)
+         return(cnf->emitter = my_emitter_map[pos]);
+
+   // default to pretty printed vici format
+   cnf->flags |= MY_FLG_PRETTY;
+   return(cnf->emitter = &my_emitter_vici);
+}
+
 
 int
-my_parse_footer_json(
+my_parse_footer(
          my_config_t *                 cnf )
 {
-   if ((cnf->widget->flags & MY_FLG_STREAM))
-   {  printf(((cnf->flags & MY_FLG_PRETTY)) ? "\n]\n" : "]\n");
+   int                     rc;
+   const my_emitter_t *    emitter;
+
+   // messages formatted by worker threads are written first
+   if ((rc = my_jobs_drain(cnf)) < 0)
+      return(rc);
+
+   // a document is completed once any reply was received, even if no
+   // reply satisfied the where predicates
+   if (!(cnf->res_count))
       return(0);
+
+   emitter = my_parse_emitter(cnf);
+   if (!(emitter->func_footer))
+      return(0);
+
+   return(emitter->func_footer(cnf));
+}
+
+
+void
+my_parse_free(
+         my_config_t *                 cnf )
+{
+   size_t            pos;
+
+   for(pos = 0; (pos < cnf->select_len); pos++)
+      my_parse_path_free(&cnf->select[pos]);
+   free(cnf->select);
+   cnf->select       = NULL;
+   cnf->select_len   = 0;
+
+   for(pos = 0; (pos < cnf->where_len); pos++)
+      my_where_free(&cnf->where[pos]);
+   free(cnf->where);
+   cnf->where        = NULL;
+   cnf->where_len    = 0;
+
+   my_buffer_free(&cnf->path);
+   my_buffer_free(&cnf->path_offs);
+   my_buffer_free(&cnf->replay_path);
+   my_buffer_free(&cnf->replay_offs);
+   my_buffer_free(&cnf->tape);
+   my_buffer_free(&cnf->tape_data);
+
+   free(cnf->names);
+   cnf->names        = NULL;
+   cnf->names_size   = 0;
+   cnf->names_len    = 0;
+   my_buffer_free(&cnf->names_data);
+
+   return;
+}
+
+
+int
+my_parse_intern(
+         my_config_t *                 cnf,
+         const char *                  name )
+{
+   size_t            pos;
+   size_t            idx;
+   size_t            len;
+   size_t            size;
+   uint32_t          hash;
+   char *            ptr;
+   my_name_t *       names;
+
+   // names are hashed case insensitively using FNV-1a
+   hash = 2166136261U;
+   for(pos = 0; ((name[pos])); pos++)
+      hash = (hash ^ (uint32_t)tolower((unsigned char)name[pos])) * 16777619U;
+
+   // search open addressed table of known names
+   for(idx = hash; ((cnf->names_size)); idx++)
+   {  idx &= cnf->names_size - 1;
+      if (!(cnf->names[idx].id))
+         break;
+      if ( (cnf->names[idx].hash == hash) && (!(strcasecmp(&cnf->names_data.data[cnf->names[idx].off], name))) )
+         return((int)cnf->names[idx].id);
    };
-   printf(((cnf->flags & MY_FLG_PRETTY)) ? "\n   }\n}\n" : "}}\n");
-   return(0);
+
+   // grow table to keep it at most half full
+   if (((cnf->names_len + 1) * 2) > cnf->names_size)
+   {  size = ((cnf->names_size)) ? (cnf->names_size * 2) : 64;
+      if ((names = calloc(size, sizeof(my_name_t))) == NULL)
+         return(-ENOMEM);
+      for(pos = 0; (pos < cnf->names_size); pos++)
+      {  if (!(cnf->names[pos].id))
+            continue;
+         for(idx = cnf->names[pos].hash & (size - 1); ((names[idx].id)); idx = (idx + 1) & (size - 1));
+         names[idx] = cnf->names[pos];
+      };
+      free(cnf->names);
+      cnf->names        = names;
+      cnf->names_size   = size;
+      for(idx = hash & (size - 1); ((names[idx].id)); idx = (idx + 1) & (size - 1));
+   };
+
+   // store name, identifiers are assigned in order starting with 1
+   len = strlen(name) + 1;
+   pos = cnf->names_data.len;
+   if ((ptr = my_buffer_alloc(&cnf->names_data, len)) == NULL)
+      return(-ENOMEM);
+   memcpy(ptr, name, len);
+   cnf->names[idx].hash = hash;
+   cnf->names[idx].id   = (unsigned)++cnf->names_len;
+   cnf->names[idx].off  = pos;
+
+   return((int)cnf->names[idx].id);
+}
+
+
+unsigned
+my_parse_level(
+         my_cursor_t *                 cur )
+{
+   if ((cur->res))
+      return((unsigned)davici_get_level(cur->res) + cur->shift);
+   return((((cur->elem)) ? cur->elem->level : 0) + cur->shift);
 }
 
 
 int
-my_parse_res_json(
-         const char *                  name,
-         struct davici_response *      res,
+my_parse_msg_start(
          my_config_t *                 cnf,
+         const my_emitter_t *          emitter,
+         const char *                  name,
          int                           is_event )
 {
    int               rc;
-   char              val[4096];
-   const char *      key;
-   unsigned          level;
-
-   if (!(cnf))
-      return(0);
 
-   // print JSON header
-   if (!(cnf->res_last_name))
-      printf(((cnf->widget->flags & MY_FLG_STREAM)) ? "[" : "{");
-
-   // print event/command section start
-   if ((cnf->widget->flags & MY_FLG_STREAM))
-   {  my_parse_res_json_delim(cnf, 0);
-      printf("\"%s-%s\": {", name, (((is_event)) ? "event" : "reply"));
-      cnf->last_was_item = 0;
-   } else
-   {  if ( (!(cnf->res_last_name)) || ((strcasecmp(name, cnf->res_last_name))) )
-      {  cnf->last_was_item = 0;
-         my_parse_res_json_delim(cnf, 0);
-         if ((cnf->res_last_name))
-         {  printf("}");
-            cnf->last_was_item = 1;
-            my_parse_res_json_delim(cnf, 0);
-         };
-         printf("\"%s-%s\": {", name, (((is_event)) ? "event" : "reply"));
-         cnf->last_was_item = 0;
-      };
+   // formats which merge consecutive messages compare interned names
+   if ((rc = my_parse_intern(cnf, name)) < 0)
+   {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      return(rc);
    };
+   cnf->res_id = (unsigned)rc;
 
-   if ( (!(cnf->res_last_name)) || ((strcasecmp(name, cnf->res_last_name))) )
-   {  free(cnf->res_last_name);
-      if ((cnf->res_last_name = strdup(name)) == NULL)
-      {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
-         return(-errno);
-      };
-   };
+   if ((rc = emitter->func_msg_start(cnf, name, is_event)) < 0)
+      return(rc);
 
-   level = davici_get_level(res) + 1;
+   cnf->res_last_id     = cnf->res_id;
+   cnf->res_last_sock   = cnf->sock;
 
-   while((rc = davici_parse(res)) >= 0)
-   {  switch(rc)
-      {  case DAVICI_END:
-            if ((cnf->widget->flags & MY_FLG_STREAM))
-            {  cnf->last_was_item = 0;
-               my_parse_res_json_delim(cnf, 0);
-               printf("}");
-            };
-            cnf->last_was_item = 1;
-            return(0);
+   return(0);
+}
 
-         case DAVICI_SECTION_START:
-            key = davici_get_name(res);
-            my_parse_res_json_delim(cnf, level);
-            printf("\"%s\": {", key);
-            cnf->last_was_item = 0;
-            break;
 
-         case DAVICI_SECTION_END:
-            cnf->last_was_item = 0;
-            my_parse_res_json_delim(cnf, level-1);
-            printf("}");
-            cnf->last_was_item = 1;
-            break;
+const char *
+my_parse_name(
+         my_cursor_t *                 cur )
+{
+   if ((cur->synthetic))
+      return((cur->synthetic == DAVICI_SECTION_START) ? cur->tag : MY_PARSE_TAG_KEY);
+   if ((cur->res))
+      return(davici_get_name(cur->res));
+   return(&cur->tape_data->data[cur->elem->name - 1]);
+}
 
-         case DAVICI_KEY_VALUE:
-            rc = my_get_value(res, val, sizeof(val), NULL);
-            if (rc < 0)
-            {  fprintf(stderr, "%s: my_get_value(): %s\n", PROGRAM_NAME, strerror(-rc));
-               return(rc);
-            };
-            key = davici_get_name(res);
-            my_parse_res_json_delim(cnf, level);
-            printf("\"%s\": \"%s\"", key, val);
-            cnf->last_was_item = 1;
-            break;
 
-         case DAVICI_LIST_START:
-            key = davici_get_name(res);
-            my_parse_res_json_delim(cnf, level);
-            printf("\"%s\": [", key);
-            cnf->last_was_item = 0;
-            break;
+int
+my_parse_next(
+         my_cursor_t *                 cur )
+{
+   int               rc;
 
-         case DAVICI_LIST_ITEM:
-            rc = my_get_value(res, val, sizeof(val), NULL);
-            if (rc < 0)
-            {  fprintf(stderr, "%s: my_get_value(): %s\n", PROGRAM_NAME, strerror(-rc));
-               return(rc);
-            };
-            my_parse_res_json_delim(cnf, level);
-            printf("\"%s\"", val);
-            cnf->last_was_item = 1;
-            break;
+   // elements identifying the socket are inserted into the message
+   if ((rc = cur->pending) != 0)
+   {  cur->pending   = 0;
+      cur->synthetic = rc;
+      if (rc == DAVICI_SECTION_START)
+         cur->shift = 1;
+      return(rc);
+   };
+   cur->synthetic = 0;
+   if ((cur->closing))
+      return(DAVICI_END);
+
+   if ((cur->res))
+      rc = davici_parse(cur->res);
+   else if (cur->pos < cur->tape->len)
+   {  cur->elem    = (const my_tape_t *)&cur->tape->data[cur->pos];
+      cur->pos    += sizeof(my_tape_t);
+      rc           = cur->elem->type;
+   } else
+      // snapshots end with the element DAVICI_END
+      rc = -EINVAL;
 
-         case DAVICI_LIST_END:
-            cnf->last_was_item = 0;
-            my_parse_res_json_delim(cnf, level-1);
-            printf("]");
-            cnf->last_was_item = 1;
-            break;
+   switch(cur->tag_mode)
+   {  case MY_PARSE_TAG_RECORD:
+         if ( (rc == DAVICI_SECTION_START) && (my_parse_level(cur) == 1) )
+            cur->pending = DAVICI_KEY_VALUE;
+         break;
 
-         default:
-            printf("UNKNOWN\n");
-            cnf->last_was_item = 0;
+      case MY_PARSE_TAG_SECTION:
+         if (rc != DAVICI_END)
             break;
-      };
-      level = davici_get_level(res) + 1;
+         cur->synthetic = DAVICI_SECTION_END;
+         cur->closing   = 1;
+         cur->shift     = 0;
+         return(DAVICI_SECTION_END);
+
+      default:
+         break;
    };
 
    return(rc);
@@ -555,420 +885,550 @@ my_parse_res_json(
 
 
 int
-my_parse_res_json_delim(
-         my_config_t *                 cnf,
-         int                           level )
+my_parse_path_compile(
+         my_path_t *                   path,
+         const char *                  spec )
 {
-   level++;
-   if ((cnf->flags & MY_FLG_PRETTY))
-      printf(((cnf->last_was_item)) ? ",\n%*s" : "\n%*s", (level*3), "");
-   else
-      printf(((cnf->last_was_item)) ? ", " : "");
+   size_t            pos;
+   char *            str;
+
+   memset(path, 0, sizeof(my_path_t));
+
+   if ((path->spec = strdup(spec)) == NULL)
+      return(-ENOMEM);
+
+   // split dotted path into segments
+   path->nsegs = 1;
+   for(pos = 0; ((spec[pos])); pos++)
+      if (spec[pos] == '.')
+         path->nsegs++;
+   if ((path->segs = malloc(sizeof(char *) * path->nsegs)) == NULL)
+      return(-ENOMEM);
+   if ((str = strdup(spec)) == NULL)
+      return(-ENOMEM);
+   path->segs[0]  = str;
+   path->nsegs    = 1;
+   for(pos = 0; ((str[pos])); pos++)
+   {  if (str[pos] != '.')
+         continue;
+      str[pos]                   = '\0';
+      path->segs[path->nsegs++]  = &str[pos+1];
+   };
+
+   for(pos = 0; (pos < path->nsegs); pos++)
+      if (!(path->segs[pos][0]))
+         return(-EINVAL);
+
    return(0);
 }
 
 
-//-----------------------//
-// vici format functions //
-//-----------------------//
-#pragma mark vici format functions
+void
+my_parse_path_free(
+         my_path_t *                   path )
+{
+   if (!(path))
+      return;
+   free(path->spec);
+   if ((path->segs))
+      free(path->segs[0]);
+   free(path->segs);
+   memset(path, 0, sizeof(my_path_t));
+   return;
+}
+
 
-int
-my_parse_res_vici(
-         const char *                  name,
-         struct davici_response *      res,
+char *
+my_parse_path_join(
          my_config_t *                 cnf,
-         int                           is_event )
+         const char *                  key )
 {
-   int               rc;
-   char              val[4096];
-   const char *      key;
-   unsigned          level;
+   size_t            pos;
+   size_t            len;
+   char *            str;
+
+   len = cnf->path.len + (((key)) ? (strlen(key) + 1) : 0);
+   if ((str = malloc(len + 1)) == NULL)
+      return(NULL);
+   if ((cnf->path.len))
+      memcpy(str, cnf->path.data, cnf->path.len);
+   if ((key))
+      strcpy(&str[cnf->path.len], key);
+   str[len] = '\0';
+
+   // segments are NUL terminated within the path buffer
+   for(pos = 0; ((pos + 1) < len); pos++)
+      if (str[pos] == '\0')
+         str[pos] = '.';
+
+   return(str);
+}
 
-   if (!(cnf))
+
+int
+my_parse_path_match(
+         my_config_t *                 cnf,
+         const my_path_t *             path,
+         const char *                  key,
+         int                           prefix )
+{
+   size_t            pos;
+   size_t            depth;
+   size_t            off;
+   const char *      seg;
+
+   // a path matches the current element, or if prefix is set, matches a
+   // descendant of the current element
+   depth = (cnf->path_offs.len / sizeof(size_t)) + (((key)) ? 1 : 0);
+   if ( ((prefix)) && (path->nsegs <= depth) )
+      return(0);
+   if ( (!(prefix)) && (path->nsegs != depth) )
       return(0);
 
-   level = davici_get_level(res) + 1;
+   for(pos = 0; (pos < depth); pos++)
+   {  if ((path->segs[pos][0] == '*') && (!(path->segs[pos][1])))
+         continue;
+      if ( ((key)) && (pos == (depth - 1)) )
+         seg = key;
+      else
+      {  memcpy(&off, &cnf->path_offs.data[pos * sizeof(size_t)], sizeof(size_t));
+         seg = &cnf->path.data[off];
+      };
+      if ((strcmp(path->segs[pos], seg)))
+         return(0);
+   };
 
-   printf("%s %s {", name, (((is_event)) ? "event" : "reply"));
-   while((rc = davici_parse(res)) >= 0)
-   {  switch(rc)
-      {  case DAVICI_END:
-            cnf->last_was_item = 0;
-            my_parse_res_vici_delim(cnf, level-1);
-            printf("}\n");
-            return(0);
+   return(1);
+}
 
-         case DAVICI_SECTION_START:
-            key = davici_get_name(res);
-            my_parse_res_vici_delim(cnf, level);
-            printf("%s {", key);
-            cnf->last_was_item = 0;
-            break;
 
-         case DAVICI_SECTION_END:
-            cnf->last_was_item = 0;
-            my_parse_res_vici_delim(cnf, level-1);
-            printf("}");
-            cnf->last_was_item = 1;
-            break;
+void
+my_parse_pop(
+         my_config_t *                 cnf )
+{
+   if (!(cnf->path_offs.len))
+      return;
 
-         case DAVICI_KEY_VALUE:
-            rc = my_get_value(res, val, sizeof(val), NULL);
-            if (rc < 0)
-            {  fprintf(stderr, "%s: my_get_value(): %s\n", PROGRAM_NAME, strerror(-rc));
-               return(rc);
-            };
-            key = davici_get_name(res);
-            my_parse_res_vici_delim(cnf, level);
-            if ((cnf->flags & MY_FLG_PRETTY))
-               printf("%s = %s", key, val);
-            else
-               printf("%s=%s", key, val);
-            cnf->last_was_item = 1;
-            break;
+   cnf->path_offs.len -= sizeof(size_t);
+   memcpy(&cnf->path.len, &cnf->path_offs.data[cnf->path_offs.len], sizeof(size_t));
 
-         case DAVICI_LIST_START:
-            key = davici_get_name(res);
-            my_parse_res_vici_delim(cnf, level);
-            printf("%s = [", key);
-            cnf->last_was_item = 0;
-            break;
+   // leaving selected or hidden section
+   if ((cnf->path_offs.len / sizeof(size_t)) < cnf->select_depth)
+      cnf->select_depth = 0;
+   if ((cnf->path_offs.len / sizeof(size_t)) < cnf->hide_depth)
+      cnf->hide_depth = 0;
 
-         case DAVICI_LIST_ITEM:
-            rc = my_get_value(res, val, sizeof(val), NULL);
-            if (rc < 0)
-            {  fprintf(stderr, "%s: my_get_value(): %s\n", PROGRAM_NAME, strerror(-rc));
-               return(rc);
-            };
-            my_parse_res_vici_delim(cnf, level);
-            printf("%s", val);
-            cnf->last_was_item = 0;
+   return;
+}
+
+
+int
+my_parse_push(
+         my_config_t *                 cnf,
+         const char *                  name )
+{
+   size_t            len;
+   size_t            off;
+   char *            ptr;
+
+   // names are stored NUL terminated along with their offsets
+   off = cnf->path.len;
+   len = strlen(name) + 1;
+   if ((ptr = my_buffer_alloc(&cnf->path, len)) == NULL)
+      return(-ENOMEM);
+   memcpy(ptr, name, len);
+   if ((ptr = my_buffer_alloc(&cnf->path_offs, sizeof(size_t))) == NULL)
+      return(-ENOMEM);
+   memcpy(ptr, &off, sizeof(size_t));
+
+   return(0);
+}
+
+
+int
+my_parse_replay(
+         my_config_t *                 cnf,
+         const my_emitter_t *          emitter,
+         int                           is_record,
+         unsigned *                    skipp )
+{
+   int               rc;
+   int               is_nested;
+   size_t            pos;
+   size_t            select_depth;
+   size_t            hide_depth;
+   unsigned          skip;
+   const char *      key;
+   my_buffer_t       buff;
+   my_value_t        val;
+   my_tape_t *       elem;
+
+   // recorded elements are replayed using a path stack of their own
+   buff                 = cnf->path;
+   cnf->path            = cnf->replay_path;
+   cnf->replay_path     = buff;
+   buff                 = cnf->path_offs;
+   cnf->path_offs       = cnf->replay_offs;
+   cnf->replay_offs     = buff;
+   select_depth         = cnf->select_depth;
+   hide_depth           = cnf->hide_depth;
+   cnf->path.len        = 0;
+   cnf->path_offs.len   = 0;
+
+   rc    = 0;
+   skip  = 0;
+   for(pos = 0; (pos < cnf->tape.len); pos += sizeof(my_tape_t))
+   {  elem = (my_tape_t *)&cnf->tape.data[pos];
+
+      // elements of a subtree declined by the emitter are not replayed
+      if ((skip))
+      {  if ( ((elem->type == DAVICI_SECTION_END) || (elem->type == DAVICI_LIST_END)) && (elem->level == skip) )
+            skip = 0;
+         continue;
+      };
+
+      key            = ((elem->name)) ? &cnf->tape_data.data[elem->name - 1] : NULL;
+      val.data       = &cnf->tape_data.data[elem->data];
+      val.len        = elem->len;
+      val.is_binary  = elem->is_binary;
+      is_nested      = ( (!(is_record)) || (elem->level != 1) ) ? 1 : 0;
+
+      switch(elem->type)
+      {  case DAVICI_SECTION_START:
+         case DAVICI_LIST_START:
+            if ( ((is_nested)) || (elem->type == DAVICI_LIST_START) )
+               if ((rc = my_parse_push(cnf, key)) < 0)
+                  break;
+            if ((rc = my_parse_dispatch(cnf, emitter, elem->type, elem->level, key, &val)) != MY_EMIT_SKIP)
+               break;
+            if ( ((is_nested)) || (elem->type == DAVICI_LIST_START) )
+               my_parse_pop(cnf);
+            skip  = elem->level;
+            rc    = 0;
             break;
 
+         case DAVICI_SECTION_END:
          case DAVICI_LIST_END:
-            my_parse_res_vici_delim(cnf, level-1);
-            printf("]");
-            cnf->last_was_item = 1;
+            rc = my_parse_dispatch(cnf, emitter, elem->type, elem->level, key, &val);
+            if ( ((is_nested)) || (elem->type == DAVICI_LIST_END) )
+               my_parse_pop(cnf);
             break;
 
          default:
-            printf("UNKNOWN\n");
-            cnf->last_was_item = 0;
+            rc = my_parse_dispatch(cnf, emitter, elem->type, elem->level, key, &val);
             break;
       };
-      level = davici_get_level(res) + 1;
+      if (rc < 0)
+         break;
    };
 
-   return(rc);
+   // restore path stack of parser
+   buff                 = cnf->path;
+   cnf->path            = cnf->replay_path;
+   cnf->replay_path     = buff;
+   buff                 = cnf->path_offs;
+   cnf->path_offs       = cnf->replay_offs;
+   cnf->replay_offs     = buff;
+   cnf->select_depth    = select_depth;
+   cnf->hide_depth      = hide_depth;
+   cnf->tape.len        = 0;
+   cnf->tape_data.len   = 0;
+
+   *skipp = skip;
+
+   return((rc < 0) ? rc : 0);
 }
 
 
 int
-my_parse_res_vici_delim(
+my_parse_res(
+         const char *                  name,
+         struct davici_response *      res,
          my_config_t *                 cnf,
-         int                           level )
+         int                           is_event )
 {
-   if ((cnf->flags & MY_FLG_PRETTY))
-      printf(((cnf->last_was_item)) ? ",\n%*s" : "\n%*s", (level*3), "");
-   else
-      printf(((cnf->last_was_item)) ? " " : "");
-   return(0);
-}
+   int                     rc;
+   my_cursor_t             cur;
+   const my_emitter_t *    emitter;
+
+   if (!(cnf))
+      return(0);
 
+   emitter = my_parse_emitter(cnf);
+   cnf->res_count++;
+
+   // messages received from multiple sockets may be merged after polling
+   if ((cnf->sock))
+      if ((rc = my_socks_defer(cnf, name, res, is_event)) <= 0)
+         return(rc);
+
+   // records may be handed to worker threads for formatting
+   if ((cnf->opt_jobs))
+      if ((rc = my_jobs_submit(cnf, name, res, is_event)) <= 0)
+         return(rc);
+
+   memset(&cur, 0, sizeof(cur));
+   cur.res = res;
+
+   return(my_parse_elems(cnf, emitter, name, &cur, is_event));
+}
 
-//----------------------//
-// xml format functions //
-//----------------------//
-#pragma mark xml format functions
 
 int
-my_parse_footer_xml(
+my_parse_select(
          my_config_t *                 cnf )
 {
-   if (!(cnf))
+   int               rc;
+   char *            str;
+   char *            spec;
+   char *            last;
+   size_t            pos;
+   void *            ptr;
+
+   // a later projection replaces any previously compiled projection
+   for(pos = 0; (pos < cnf->select_len); pos++)
+      my_parse_path_free(&cnf->select[pos]);
+   free(cnf->select);
+   cnf->select       = NULL;
+   cnf->select_len   = 0;
+
+   if (!(cnf->opt_select))
       return(0);
-   printf(((cnf->flags & MY_FLG_PRETTY)) ? "\n</vici>\n" : "</vici>\n");
+
+   // compile projection into list of dotted paths
+   if ((str = strdup(cnf->opt_select)) == NULL)
+   {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      return(-ENOMEM);
+   };
+   for(spec = strtok_r(str, ",", &last); ((spec)); spec = strtok_r(NULL, ",", &last))
+   {  if ((ptr = realloc(cnf->select, sizeof(my_path_t) * (cnf->select_len + 1))) == NULL)
+      {  free(str);
+         fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+         return(-ENOMEM);
+      };
+      cnf->select = ptr;
+      rc = my_parse_path_compile(&cnf->select[cnf->select_len++], spec);
+      if (rc == -EINVAL)
+         fprintf(stderr, "%s: invalid select path `%s'\n", my_prog_name(cnf), spec);
+      else if (rc < 0)
+         fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      if (rc < 0)
+      {  free(str);
+         return(rc);
+      };
+   };
+   free(str);
+
    return(0);
 }
 
 
 int
-my_parse_res_xml(
-         const char *                  name,
-         struct davici_response *      res,
+my_parse_selected(
          my_config_t *                 cnf,
-         int                           is_event )
+         const char *                  key,
+         int                           is_section )
 {
-   int               rc;
-   int               i;
-   char              val[4096];
-   const char *      key;
-   unsigned          level;
-   char *            sects[MY_SECTS_MAX_DEPTH];
+   size_t            pos;
 
-   if (!(cnf))
-      return(0);
+   if (!(cnf->select_len))
+      return(1);
 
-   for(i = 0; (i < MY_SECTS_MAX_DEPTH); i++)
-      sects[i] = NULL;
+   // descendants of a selected section are selected
+   if ((cnf->select_depth))
+      return(1);
 
-   // print JSON header
-   if (!(cnf->res_last_name))
-   {  printf("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
-      printf("<vici>");
+   for(pos = 0; (pos < cnf->select_len); pos++)
+   {  if ((my_parse_path_match(cnf, &cnf->select[pos], key, 0)))
+      {  if ((is_section))
+            cnf->select_depth = cnf->path_offs.len / sizeof(size_t);
+         return(1);
+      };
+      if ( ((is_section)) && ((my_parse_path_match(cnf, &cnf->select[pos], NULL, 1))) )
+         return(1);
    };
 
-   // print event/command section start
-   my_parse_res_xml_delim(cnf, 0);
-   printf("<%s-%s>", name, (((is_event)) ? "event" : "reply"));
+   return(0);
+}
 
-   if ( (!(cnf->res_last_name)) || ((strcasecmp(name, cnf->res_last_name))) )
-   {  free(cnf->res_last_name);
-      if ((cnf->res_last_name = strdup(name)) == NULL)
-      {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
-         return(-errno);
-      };
-   };
 
-   level = davici_get_level(res) + 1;
+int
+my_parse_snapshot(
+         struct davici_response *      res,
+         my_buffer_t *                 tape,
+         my_buffer_t *                 tape_data )
+{
+   int               rc;
+   size_t            len;
+   unsigned int      vlen;
+   char *            ptr;
+   const char *      str;
+   my_tape_t *       elem;
+
+   tape->len      = 0;
+   tape_data->len = 0;
 
+   // elements are copied along with the level of the parser after each
+   // element, values are checked for printable text when formatted
    while((rc = davici_parse(res)) >= 0)
-   {  switch(rc)
+   {  if ((elem = (my_tape_t *)my_buffer_alloc(tape, sizeof(my_tape_t))) == NULL)
+         return(-ENOMEM);
+      memset(elem, 0, sizeof(my_tape_t));
+      elem->type  = rc;
+      elem->level = (unsigned)davici_get_level(res);
+      switch(rc)
       {  case DAVICI_END:
-            my_parse_res_xml_delim(cnf, level-1);
-            printf("</%s-%s>", name, (((is_event)) ? "event" : "reply"));
-            my_parse_res_xml_sect_free(sects);
             return(0);
 
          case DAVICI_SECTION_START:
-            key = davici_get_name(res);
-            if ((rc = my_parse_res_xml_sect_set(cnf, sects, level, key)) != 0)
-            {  my_parse_res_xml_sect_free(sects);
-               return(rc);
-            };
-            my_parse_res_xml_delim(cnf, level);
-            printf("<%s>", sects[level]);
-            break;
-
-         case DAVICI_SECTION_END:
-            my_parse_res_xml_delim(cnf, level-1);
-            printf("</%s>", sects[level-1]);
-            break;
-
-         case DAVICI_KEY_VALUE:
-            rc = my_get_value(res, val, sizeof(val), NULL);
-            if (rc < 0)
-            {  fprintf(stderr, "%s: my_get_value(): %s\n", PROGRAM_NAME, strerror(-rc));
-               my_parse_res_xml_sect_free(sects);
-               return(rc);
-            };
-            key = davici_get_name(res);
-            my_parse_res_xml_delim(cnf, level);
-            printf("<%s>%s</%s>", key, val, key);
-            break;
-
          case DAVICI_LIST_START:
-            key = davici_get_name(res);
-            if ((rc = my_parse_res_xml_sect_set(cnf, sects, level, key)) != 0)
-            {  my_parse_res_xml_sect_free(sects);
-               return(rc);
-            };
-            my_parse_res_xml_delim(cnf, level);
-            printf("<%s>", sects[level]);
-            break;
+         case DAVICI_KEY_VALUE:
+            str         = davici_get_name(res);
+            len         = strlen(str) + 1;
+            elem->name  = tape_data->len + 1;
+            if ((ptr = my_buffer_alloc(tape_data, len)) == NULL)
+               return(-ENOMEM);
+            memcpy(ptr, str, len);
+            if (rc != DAVICI_KEY_VALUE)
+               break;
+            // fall through
 
          case DAVICI_LIST_ITEM:
-            rc = my_get_value(res, val, sizeof(val), NULL);
-            if (rc < 0)
-            {  fprintf(stderr, "%s: my_get_value(): %s\n", PROGRAM_NAME, strerror(-rc));
-               my_parse_res_xml_sect_free(sects);
-               return(rc);
-            };
-            my_parse_res_xml_delim(cnf, level);
-            printf("<item>%s<item>", val);
-            break;
-
-         case DAVICI_LIST_END:
-            my_parse_res_xml_delim(cnf, level-1);
-            printf("</%s>", sects[level-1]);
+            if ((str = davici_get_value(res, &vlen)) == NULL)
+               vlen = 0;
+            elem->data  = tape_data->len;
+            elem->len   = vlen;
+            if ((ptr = my_buffer_alloc(tape_data, vlen)) == NULL)
+               return(-ENOMEM);
+            if ((vlen))
+               memcpy(ptr, str, vlen);
             break;
 
          default:
-            printf("UNKNOWN\n");
-            cnf->last_was_item = 0;
             break;
       };
-      level = davici_get_level(res) + 1;
    };
 
-   my_parse_res_xml_sect_free(sects);
-
    return(rc);
 }
 
 
 int
-my_parse_res_xml_delim(
+my_parse_tape(
          my_config_t *                 cnf,
-         int                           level )
+         const char *                  name,
+         const my_buffer_t *           tape,
+         const my_buffer_t *           tape_data,
+         int                           is_event )
 {
-   level++;
-   if ((cnf->flags & MY_FLG_PRETTY))
-      printf("\n%*s", (level*3), "");
-   return(0);
+   my_cursor_t       cur;
+
+   memset(&cur, 0, sizeof(cur));
+   cur.tape       = tape;
+   cur.tape_data  = tape_data;
+
+   return(my_parse_elems(cnf, my_parse_emitter(cnf), name, &cur, is_event));
 }
 
 
 void
-my_parse_res_xml_sect_free(
-         char **                       sections )
+my_parse_unit(
+         my_config_t *                 cnf )
 {
-   int i;
-   for(i = 0; (i < MY_SECTS_MAX_DEPTH); i++)
-   {  if ((sections[i]))
-         free(sections[i]);
-      sections[i] = NULL;
-   };
+   size_t            pos;
+
+   for(pos = 0; (pos < cnf->where_len); pos++)
+      cnf->where[pos].state = 0;
+   cnf->tape.len        = 0;
+   cnf->tape_data.len   = 0;
+   cnf->where_state     = MY_PARSE_PENDING;
+
    return;
 }
 
 
 int
-my_parse_res_xml_sect_set(
+my_parse_where(
          my_config_t *                 cnf,
-         char **                       sects,
-         int                           level,
-         const char *                  sect )
+         const char *                  expr )
 {
-   assert(level < MY_SECTS_MAX_DEPTH);
-
-   if ((sects[level]))
-      free(sects[level]);
+   int               rc;
+   void *            ptr;
 
-   if ((sects[level] = strdup(sect)) == NULL)
-   {  fprintf(stderr, "%s: strdup(): %s\n", my_prog_name(cnf), strerror(errno));
-      return(-errno);
+   // each expression is a predicate which must match along with any
+   // previously compiled predicates
+   if ((ptr = realloc(cnf->where, sizeof(my_where_t) * (cnf->where_len + 1))) == NULL)
+   {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      return(-ENOMEM);
+   };
+   cnf->where = ptr;
+   if ((rc = my_where_compile(&cnf->where[cnf->where_len], expr)) < 0)
+   {  my_where_free(&cnf->where[cnf->where_len]);
+      if (rc == -EINVAL)
+         fprintf(stderr, "%s: invalid where expression `%s'\n", my_prog_name(cnf), expr);
+      else
+         fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      return(rc);
    };
+   cnf->where_len++;
 
    return(0);
 }
 
 
-//-----------------------//
-// yaml format functions //
-//-----------------------//
-#pragma mark yaml format functions
-
 int
-my_parse_res_yaml(
-         const char *                  name,
-         struct davici_response *      res,
+my_parse_where_needs(
          my_config_t *                 cnf,
-         int                           is_event )
+         int                           prefix )
 {
-   int               rc;
-   char              val[4096];
-   const char *      key;
-   unsigned          level;
+   size_t            pos;
 
-   if (!(cnf))
+   if (cnf->where_state != MY_PARSE_PENDING)
       return(0);
 
-   if (!(cnf->res_last_name))
-      printf("---\n");
-
-   if ( (!(cnf->res_last_name)) || ((strcasecmp(name, cnf->res_last_name))) )
-   {  my_parse_res_yaml_delim(cnf, 0);
-      printf(  "%s%s-%s:\n",
-               (((cnf->widget->flags & MY_FLG_STREAM)) ? "- " : ""),
-               name,
-               (((is_event)) ? "event" : "reply")
-            );
-   };
-
-   if ( (!(cnf->res_last_name)) || ((strcasecmp(name, cnf->res_last_name))) )
-   {  free(cnf->res_last_name);
-      if ((cnf->res_last_name = strdup(name)) == NULL)
-      {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
-         return(-errno);
-      };
-   };
-
-   level = davici_get_level(res) + 1;
-
-   while((rc = davici_parse(res)) >= 0)
-   {  switch(rc)
-      {  case DAVICI_END:
-            cnf->last_was_item = 1;
-            return(0);
-
-         case DAVICI_SECTION_START:
-            key = davici_get_name(res);
-            my_parse_res_yaml_delim(cnf, level);
-            printf("%s:\n", key);
-            cnf->last_was_item = 0;
-            break;
-
-         case DAVICI_SECTION_END:
-            cnf->last_was_item = 1;
-            break;
-
-         case DAVICI_KEY_VALUE:
-            rc = my_get_value(res, val, sizeof(val), NULL);
-            if (rc < 0)
-            {  fprintf(stderr, "%s: my_get_value(): %s\n", PROGRAM_NAME, strerror(-rc));
-               return(rc);
-            };
-            key = davici_get_name(res);
-            my_parse_res_yaml_delim(cnf, level);
-            printf("%s: %s\n", key, val);
-            cnf->last_was_item = 1;
-            break;
-
-         case DAVICI_LIST_START:
-            key = davici_get_name(res);
-            my_parse_res_yaml_delim(cnf, level);
-            printf("%s:\n", key);
-            cnf->last_was_item = 0;
-            break;
-
-         case DAVICI_LIST_ITEM:
-            rc = my_get_value(res, val, sizeof(val), NULL);
-            if (rc < 0)
-            {  fprintf(stderr, "%s: my_get_value(): %s\n", PROGRAM_NAME, strerror(-rc));
-               return(rc);
-            };
-            my_parse_res_yaml_delim(cnf, level);
-            printf("- %s\n", val);
-            cnf->last_was_item = 0;
-            break;
-
-         case DAVICI_LIST_END:
-            cnf->last_was_item = 1;
-            break;
-
-         default:
-            printf("UNKNOWN\n");
-            cnf->last_was_item = 0;
-            break;
-      };
-      level = davici_get_level(res) + 1;
-   };
+   for(pos = 0; (pos < cnf->where_len); pos++)
+      if ( (!(cnf->where[pos].state)) && ((my_parse_path_match(cnf, &cnf->where[pos].path, NULL, prefix))) )
+         return(1);
 
-   return(rc);
+   return(0);
 }
 
 
 int
-my_parse_res_yaml_delim(
+my_parse_where_test(
          my_config_t *                 cnf,
-         int                           level )
+         const char *                  key,
+         const char *                  data,
+         size_t                        len )
 {
-   if (!(cnf))
-      return(0);
-   printf(((cnf->last_was_item)) ? "%*s" : "%*s", (level*3), "");
-   return(0);
+   size_t            pos;
+   size_t            seg;
+   int               result;
+   my_where_t *      where;
+
+   // predicates are satisfied by any matching element, a key without
+   // wildcards in its path only occurs once within a unit
+   result = 1;
+   for(pos = 0; (pos < cnf->where_len); pos++)
+   {  where = &cnf->where[pos];
+      if ( (!(where->state)) && ((my_parse_path_match(cnf, &where->path, key, 0))) )
+      {  if ((my_where_eval(where, data, len)))
+            where->state = 1;
+         else if ((key))
+         {  for(seg = 0; (seg < where->path.nsegs); seg++)
+               if (!(strcmp(where->path.segs[seg], "*")))
+                  break;
+            if (seg == where->path.nsegs)
+               where->state = -1;
+         };
+      };
+      if (where->state < 0)
+         return(-1);
+      if (!(where->state))
+         result = 0;
+   };
+
+   return(result);
 }
 
 
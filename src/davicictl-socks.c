@@ -0,0 +1,649 @@
+/*
+ *  Davici Utilities for Strongswan
+ *  Copyright (C) 2026 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __SRC_DAVICICTL_SOCKS_C 1
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include "davicictl.h"
+
+#include <errno.h>
+#include <glob.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+
+#include <davici.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#define MY_SOCKS_EVENTS       16
+
+// epoll events identify the index of the socket and whether the socket or
+// the deadline timer of the socket is ready
+#define MY_SOCKS_KEY(cnf, sock)  (((uint64_t)((sock) - (cnf)->socks)) << 1)
+#define MY_SOCKS_TIMER           ((uint64_t)1)
+#define MY_SOCKS_SIGNAL          (~(uint64_t)0)
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+#pragma mark - Datatypes
+
+struct _my_backlog
+{  int                           is_event;
+   char *                        name;
+   my_buffer_t                   tape;
+   my_buffer_t                   tape_data;
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static size_t
+my_socks_active(
+         my_config_t *                 cnf );
+
+
+static int
+my_socks_add(
+         my_config_t *                 cnf,
+         const char *                  path );
+
+
+static void
+my_socks_close(
+         my_config_t *                 cnf,
+         my_sock_t *                   sock );
+
+
+static int
+my_socks_deadline(
+         my_config_t *                 cnf,
+         my_sock_t *                   sock );
+
+
+static void
+my_socks_expire(
+         my_config_t *                 cnf,
+         my_sock_t *                   sock );
+
+
+static int
+my_socks_fdcb(
+         struct davici_conn *          conn,
+         int                           fd,
+         int                           ops,
+         void *                        user );
+
+
+static int
+my_socks_poll(
+         my_config_t *                 cnf );
+
+
+static int
+my_socks_replay(
+         my_config_t *                 cnf,
+         my_sock_t *                   sock );
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+size_t
+my_socks_active(
+         my_config_t *                 cnf )
+{
+   size_t            pos;
+   size_t            active;
+
+   active = 0;
+   for(pos = 0; (pos < cnf->socks_len); pos++)
+      if (cnf->socks[pos].fd != -1)
+         active++;
+
+   return(active);
+}
+
+
+int
+my_socks_add(
+         my_config_t *                 cnf,
+         const char *                  path )
+{
+   size_t            pos;
+   void *            ptr;
+   my_sock_t *       sock;
+
+   // sockets matched by multiple patterns are only queried once
+   for(pos = 0; (pos < cnf->socks_len); pos++)
+      if (!(strcmp(cnf->socks[pos].path, path)))
+         return(0);
+
+   if ((ptr = realloc(cnf->socks, sizeof(my_sock_t) * (cnf->socks_len + 1))) == NULL)
+      return(-ENOMEM);
+   cnf->socks = ptr;
+   sock       = &cnf->socks[cnf->socks_len];
+   memset(sock, 0, sizeof(my_sock_t));
+   sock->fd          = -1;
+   sock->timer_fd    = -1;
+   sock->cnf         = cnf;
+   if ((sock->path = strdup(path)) == NULL)
+      return(-ENOMEM);
+   cnf->socks_len++;
+
+   return(0);
+}
+
+
+void
+my_socks_close(
+         my_config_t *                 cnf,
+         my_sock_t *                   sock )
+{
+   // remaining sockets continue to be polled
+   if (sock->fd != -1)
+      epoll_ctl(cnf->epfd, EPOLL_CTL_DEL, sock->fd, NULL);
+   sock->fd = -1;
+   if (sock->timer_fd != -1)
+      close(sock->timer_fd);
+   sock->timer_fd = -1;
+
+   // responses to commands queued on socket are no longer expected
+   if ((sock->queued))
+   {  cnf->queued   -= sock->queued;
+      sock->queued   = 0;
+      if (cnf->queued <= 0)
+         my_should_exit = 1;
+   };
+
+   return;
+}
+
+
+int
+my_socks_deadline(
+         my_config_t *                 cnf,
+         my_sock_t *                   sock )
+{
+   struct epoll_event   event;
+
+   if ((sock->timer_fd = my_deadline_start(cnf)) == -1)
+      return(-1);
+
+   memset(&event, 0, sizeof(event));
+   event.events   = EPOLLIN;
+   event.data.u64 = MY_SOCKS_KEY(cnf, sock) | MY_SOCKS_TIMER;
+   if (epoll_ctl(cnf->epfd, EPOLL_CTL_ADD, sock->timer_fd, &event) == -1)
+   {  fprintf(stderr, "%s: epoll_ctl(): %s\n", my_prog_name(cnf), strerror(errno));
+      return(-1);
+   };
+
+   return(0);
+}
+
+
+int
+my_socks_defer(
+         my_config_t *                 cnf,
+         const char *                  name,
+         struct davici_response *      res,
+         int                           is_event )
+{
+   int               rc;
+   void *            ptr;
+   my_sock_t *       sock;
+   my_backlog_t *    msg;
+
+   sock = cnf->sock;
+
+   // streams and events which are not the result of a queued command are
+   // written as they are received
+   if ((cnf->widget->flags & MY_FLG_STREAM))
+      return(1);
+   if ( ((is_event)) && (!(sock->queued)) )
+      return(1);
+
+   if ((ptr = realloc(sock->backlog, sizeof(my_backlog_t) * (sock->backlog_len + 1))) == NULL)
+      return(-ENOMEM);
+   sock->backlog  = ptr;
+   msg            = &sock->backlog[sock->backlog_len];
+   memset(msg, 0, sizeof(my_backlog_t));
+   msg->is_event  = is_event;
+   if ((msg->name = strdup(name)) == NULL)
+      return(-ENOMEM);
+   sock->backlog_len++;
+
+   if ((rc = my_parse_snapshot(res, &msg->tape, &msg->tape_data)) < 0)
+      return(rc);
+
+   return(0);
+}
+
+
+int
+my_socks_exec(
+         my_config_t *                 cnf )
+{
+   int                  rc;
+   int                  queued;
+   size_t               pos;
+   size_t               conns;
+   my_sock_t *          sock;
+   struct epoll_event   event;
+
+   if ((cnf->epfd = epoll_create1(EPOLL_CLOEXEC)) == -1)
+   {  fprintf(stderr, "%s: epoll_create1(): %s\n", my_prog_name(cnf), strerror(errno));
+      return(1);
+   };
+   memset(&event, 0, sizeof(event));
+   event.events   = EPOLLIN;
+   event.data.u64 = MY_SOCKS_SIGNAL;
+   if (epoll_ctl(cnf->epfd, EPOLL_CTL_ADD, cnf->signal_fd, &event) == -1)
+   {  fprintf(stderr, "%s: epoll_ctl(): %s\n", my_prog_name(cnf), strerror(errno));
+      return(1);
+   };
+
+   // replies of sockets are written to a single document as each socket
+   // completes, either nested in a section named after the socket or
+   // tagged with the path of the socket. Replies written as rows are
+   // records named after the socket.
+   if ( (!(cnf->widget->flags & MY_FLG_STREAM)) && ((my_parse_emitter(cnf)->flags & MY_EMIT_ROWS)) )
+      cnf->flags |= MY_FLG_RECORDS;
+
+   // connect to vici sockets, unreachable sockets are skipped
+   conns = 0;
+   for(pos = 0; (pos < cnf->socks_len); pos++)
+   {  sock = &cnf->socks[pos];
+      my_verbose(cnf, "connecting to vici socket %s ...\n", sock->path);
+      if ((rc = davici_connect_unix(sock->path, my_socks_fdcb, sock, &sock->conn)) < 0)
+      {  fprintf(stderr, "%s: %s: %s\n", my_prog_name(cnf), sock->path, strerror(-rc));
+         sock->err   = rc;
+         sock->conn  = NULL;
+         cnf->socks_err++;
+         continue;
+      };
+      conns++;
+   };
+   if (!(conns))
+      return(1);
+
+   // queue requests of widget on each socket
+   cnf->stats.queued = my_time_ns();
+   for(pos = 0; (pos < cnf->socks_len); pos++)
+   {  sock = &cnf->socks[pos];
+      if (!(sock->conn))
+         continue;
+      cnf->sock         = sock;
+      cnf->davici_conn  = sock->conn;
+      queued            = cnf->queued;
+      rc                = cnf->widget->func_exec(cnf);
+      sock->queued      = cnf->queued - queued;
+      cnf->davici_conn  = NULL;
+      if ((rc))
+         return(rc);
+      // responses to requests of each socket are awaited until the deadline
+      if ((cnf->opt_deadline))
+         if ((my_socks_deadline(cnf, sock)))
+            return(1);
+   };
+
+   rc = my_socks_poll(cnf);
+
+   // replies of sockets which had not completed when polling stopped
+   for(pos = 0; (pos < cnf->socks_len); pos++)
+      if (my_socks_replay(cnf, &cnf->socks[pos]) < 0)
+         return(1);
+
+   return(rc);
+}
+
+
+void
+my_socks_expire(
+         my_config_t *                 cnf,
+         my_sock_t *                   sock )
+{
+   // stream of events of socket ends at the deadline
+   if (!(sock->queued))
+   {  my_verbose(cnf, "deadline of %u ms expired on %s ...\n", cnf->opt_deadline, sock->path);
+      my_socks_close(cnf, sock);
+      return;
+   };
+
+   // requests which are outstanding at the deadline are abandoned by
+   // disconnecting from the vici socket
+   fprintf(stderr, "%s: %s: deadline of %u ms expired (outstanding requests: %d)\n", my_prog_name(cnf), sock->path, cnf->opt_deadline, sock->queued);
+   sock->err      = -ETIMEDOUT;
+   cnf->expired   = 1;
+   my_socks_close(cnf, sock);
+   my_verbose(cnf, "disconnecting from vici socket %s ...\n", sock->path);
+   davici_disconnect(sock->conn);
+   sock->conn     = NULL;
+
+   return;
+}
+
+
+void
+my_socks_fail(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           err )
+{
+   my_sock_t *       sock;
+
+   sock = cnf->sock;
+   if ((sock->err))
+      return;
+
+   fprintf(stderr, "%s: %s: %s: %s\n", my_prog_name(cnf), sock->path, name, strerror(-err));
+   sock->err = err;
+   cnf->socks_err++;
+   my_socks_close(cnf, sock);
+
+   return;
+}
+
+
+int
+my_socks_fdcb(
+         struct davici_conn *          conn,
+         int                           fd,
+         int                           ops,
+         void *                        user )
+{
+   int                  op;
+   my_sock_t *          sock;
+   struct epoll_event   event;
+
+   if (!(conn))
+      return(0);
+
+   sock = (my_sock_t *)user;
+   if ((sock->err))
+      return(0);
+
+   memset(&event, 0, sizeof(event));
+   event.events     = ((ops & DAVICI_READ))   ? EPOLLIN   : 0;
+   event.events    |= ((ops & DAVICI_WRITE))  ? EPOLLOUT  : 0;
+   event.data.u64   = MY_SOCKS_KEY(sock->cnf, sock);
+
+   if (!(event.events))
+      op = EPOLL_CTL_DEL;
+   else
+      op = (sock->fd == -1) ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+   if ( (op == EPOLL_CTL_DEL) && (sock->fd == -1) )
+      return(0);
+
+   if (epoll_ctl(sock->cnf->epfd, op, fd, &event) == -1)
+      return(-errno);
+   sock->fd = ((event.events)) ? fd : -1;
+
+   return(0);
+}
+
+
+void
+my_socks_free(
+         my_config_t *                 cnf )
+{
+   size_t            pos;
+   size_t            idx;
+   my_sock_t *       sock;
+
+   for(pos = 0; (pos < cnf->socks_len); pos++)
+   {  sock = &cnf->socks[pos];
+      if ((sock->conn))
+      {  my_verbose(cnf, "disconnecting from vici socket %s ...\n", sock->path);
+         davici_disconnect(sock->conn);
+      };
+      for(idx = 0; (idx < sock->backlog_len); idx++)
+      {  free(sock->backlog[idx].name);
+         my_buffer_free(&sock->backlog[idx].tape);
+         my_buffer_free(&sock->backlog[idx].tape_data);
+      };
+      free(sock->backlog);
+      free(sock->path);
+      if (sock->timer_fd != -1)
+         close(sock->timer_fd);
+   };
+   free(cnf->socks);
+   cnf->socks     = NULL;
+   cnf->socks_len = 0;
+   cnf->sock      = NULL;
+
+   if (cnf->epfd != -1)
+      close(cnf->epfd);
+   cnf->epfd = -1;
+
+   return;
+}
+
+
+int
+my_socks_open(
+         my_config_t *                 cnf )
+{
+   int               rc;
+   size_t            pos;
+   char *            str;
+   char *            spec;
+   char *            last;
+   glob_t            pglob;
+
+   if ((str = strdup(cnf->vici_sockpath)) == NULL)
+   {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      return(-ENOMEM);
+   };
+
+   // expand comma separated list of sockets and shell patterns
+   rc = 0;
+   for(spec = strtok_r(str, ",", &last); ( ((spec)) && (!(rc)) ); spec = strtok_r(NULL, ",", &last))
+   {  if (!(strpbrk(spec, "*?[")))
+      {  rc = my_socks_add(cnf, spec);
+         continue;
+      };
+      switch(glob(spec, 0, NULL, &pglob))
+      {  case 0:
+            for(pos = 0; ( (pos < pglob.gl_pathc) && (!(rc)) ); pos++)
+               rc = my_socks_add(cnf, pglob.gl_pathv[pos]);
+            globfree(&pglob);
+            break;
+
+         case GLOB_NOMATCH:
+            fprintf(stderr, "%s: no vici sockets match `%s'\n", my_prog_name(cnf), spec);
+            rc = -ENOENT;
+            break;
+
+         case GLOB_NOSPACE:
+            rc = -ENOMEM;
+            break;
+
+         default:
+            fprintf(stderr, "%s: %s: unable to read directory\n", my_prog_name(cnf), spec);
+            rc = -EIO;
+            break;
+      };
+   };
+   free(str);
+
+   if (rc == -ENOMEM)
+      fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+   if (rc < 0)
+      return(rc);
+
+   if (!(cnf->socks_len))
+   {  fprintf(stderr, "%s: missing path to vici socket\n", my_prog_name(cnf));
+      return(-EINVAL);
+   };
+   cnf->vici_sockpath = cnf->socks[0].path;
+
+   return(0);
+}
+
+
+int
+my_socks_poll(
+         my_config_t *                 cnf )
+{
+   int                  rc;
+   int                  pos;
+   int                  nfds;
+   my_sock_t *          sock;
+   struct epoll_event   events[MY_SOCKS_EVENTS];
+
+   // poll for responses
+   my_verbose(cnf, "entering polling loop ...\n");
+   while ( (!(my_should_exit)) && ((my_socks_active(cnf))) )
+   {  // write formatted responses before waiting for more data
+      if ((my_out_flush(cnf)))
+         return(1);
+
+      if ((nfds = epoll_wait(cnf->epfd, events, MY_SOCKS_EVENTS, 30000)) < 0)
+      {  switch(errno)
+         {  case EINTR: break;
+
+            default:
+               fprintf(stderr, "%s: epoll_wait(): %s\n", my_prog_name(cnf), strerror(errno));
+               return(1);
+               break;
+         };
+         continue;
+      };
+
+      for(pos = 0; ( (pos < nfds) && (!(my_should_exit)) ); pos++)
+      {  if (events[pos].data.u64 == MY_SOCKS_SIGNAL)
+         {  my_signal(cnf);
+            continue;
+         };
+         sock              = &cnf->socks[events[pos].data.u64 >> 1];
+         cnf->sock         = sock;
+         if ((events[pos].data.u64 & MY_SOCKS_TIMER))
+         {  if (sock->timer_fd != -1)
+               my_socks_expire(cnf, sock);
+            if (my_socks_replay(cnf, sock) < 0)
+               return(1);
+            continue;
+         };
+         cnf->davici_conn  = sock->conn;
+         if ( (!(sock->err)) && ((events[pos].events & (EPOLLIN | EPOLLERR | EPOLLHUP))) )
+         {  my_verbose(cnf, "reading data from vici socket %s ...\n", sock->path);
+            if ((rc = davici_read(sock->conn)) < 0)
+               my_socks_fail(cnf, "davici_read()", rc);
+         };
+         if ( (!(sock->err)) && ((events[pos].events & EPOLLOUT)) )
+         {  my_verbose(cnf, "writing data to vici socket %s ...\n", sock->path);
+            if ((rc = davici_write(sock->conn)) < 0)
+               my_socks_fail(cnf, "davici_write()", rc);
+         };
+         cnf->davici_conn  = NULL;
+
+         // replies are written once all requests of the socket completed
+         if ( ((sock->err)) || (sock->queued <= 0) )
+            if (my_socks_replay(cnf, sock) < 0)
+               return(1);
+      };
+   };
+
+   return((my_should_exit < 0) ? 1 : 0);
+}
+
+
+int
+my_socks_replay(
+         my_config_t *                 cnf,
+         my_sock_t *                   sock )
+{
+   int               rc;
+   size_t            pos;
+   my_backlog_t *    msg;
+
+   if (!(sock->backlog_len))
+      return(0);
+
+   if ((rc = my_jobs_drain(cnf)) < 0)
+      return(rc);
+
+   // replies of each socket are written as one part of the document, so
+   // records of different daemons sharing a name are never keys of the
+   // same map
+   cnf->sock = sock;
+   rc        = 0;
+   for(pos = 0; ( (pos < sock->backlog_len) && (rc >= 0) ); pos++)
+   {  msg = &sock->backlog[pos];
+      if ((rc = my_parse_tape(cnf, msg->name, &msg->tape, &msg->tape_data, msg->is_event)) < 0)
+         fprintf(stderr, "%s: %s: %s\n", my_prog_name(cnf), msg->name, strerror(-rc));
+   };
+
+   // snapshots are released once written
+   for(pos = 0; (pos < sock->backlog_len); pos++)
+   {  free(sock->backlog[pos].name);
+      my_buffer_free(&sock->backlog[pos].tape);
+      my_buffer_free(&sock->backlog[pos].tape_data);
+   };
+   free(sock->backlog);
+   sock->backlog     = NULL;
+   sock->backlog_len = 0;
+
+   return(rc);
+}
+
+/* end of source */
@@ -0,0 +1,371 @@
+/*
+ *  Davici Utilities for Strongswan
+ *  Copyright (C) 2026 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __SRC_DAVICICTL_WHERE_C 1
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include "davicictl.h"
+
+#include <assert.h>
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef   MY_WHERE_NUM_MAX
+#define  MY_WHERE_NUM_MAX     64
+
+#undef   MY_WHERE_SIGNED
+#define  MY_WHERE_SIGNED      1
+#undef   MY_WHERE_UNSIGNED
+#define  MY_WHERE_UNSIGNED    2
+#undef   MY_WHERE_REAL
+#define  MY_WHERE_REAL        3
+
+
+//////////////
+//          //
+//  Macros  //
+//          //
+//////////////
+// MARK: - Macros
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+#pragma mark - Datatypes
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static int
+my_where_addr(
+         const char *                  data,
+         size_t                        len,
+         int                           family,
+         uint8_t *                     addr,
+         unsigned *                    bitsp );
+
+
+static int
+my_where_num(
+         const char *                  data,
+         size_t                        len,
+         my_number_t *                 num );
+
+
+static int
+my_where_numcmp(
+         const my_number_t *           a,
+         const my_number_t *           b );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+// MARK: - Variables
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+my_where_addr(
+         const char *                  data,
+         size_t                        len,
+         int                           family,
+         uint8_t *                     addr,
+         unsigned *                    bitsp )
+{
+   char              buff[INET6_ADDRSTRLEN + 8];
+   char *            slash;
+   char *            end;
+   unsigned long     bits;
+   unsigned          max;
+
+   if (len >= sizeof(buff))
+      return(-EINVAL);
+   memcpy(buff, data, len);
+   buff[len] = '\0';
+
+   // address with optional prefix length
+   max = (family == AF_INET) ? 32 : 128;
+   if ((slash = strchr(buff, '/')) != NULL)
+   {  *slash++ = '\0';
+      bits     = strtoul(slash, &end, 10);
+      if ( (!(slash[0])) || ((end[0])) || (bits > max) )
+         return(-EINVAL);
+      *bitsp = (unsigned)bits;
+   }
+   else
+   {  *bitsp = max;
+   };
+
+   if (inet_pton(family, buff, addr) != 1)
+      return(-EINVAL);
+
+   return(0);
+}
+
+
+int
+my_where_compile(
+         my_where_t *                  where,
+         const char *                  spec )
+{
+   int               rc;
+   size_t            pos;
+   size_t            oplen;
+   char *            path;
+
+   memset(where, 0, sizeof(my_where_t));
+
+   if ((where->expr = strdup(spec)) == NULL)
+      return(-ENOMEM);
+
+   // split expression into path, operator and value
+   pos = strcspn(spec, "!^<>=~");
+   if ( (!(pos)) || (!(spec[pos])) )
+      return(-EINVAL);
+   oplen = 1;
+   if      (!(strncmp(&spec[pos], "!=", 2))) { where->op = MY_WHERE_NE;     oplen = 2; }
+   else if (!(strncmp(&spec[pos], "^=", 2))) { where->op = MY_WHERE_PREFIX; oplen = 2; }
+   else if (!(strncmp(&spec[pos], "<=", 2))) { where->op = MY_WHERE_LE;     oplen = 2; }
+   else if (!(strncmp(&spec[pos], ">=", 2))) { where->op = MY_WHERE_GE;     oplen = 2; }
+   else if (spec[pos] == '<')                  where->op = MY_WHERE_LT;
+   else if (spec[pos] == '>')                  where->op = MY_WHERE_GT;
+   else if (spec[pos] == '=')                  where->op = MY_WHERE_EQ;
+   else if (spec[pos] == '~')                  where->op = MY_WHERE_CIDR;
+   else
+      return(-EINVAL);
+
+   if ((path = malloc(pos + 1)) == NULL)
+      return(-ENOMEM);
+   memcpy(path, spec, pos);
+   path[pos] = '\0';
+   rc = my_parse_path_compile(&where->path, path);
+   free(path);
+   if (rc < 0)
+      return(rc);
+   if ((where->value = strdup(&spec[pos + oplen])) == NULL)
+      return(-ENOMEM);
+   where->value_len = strlen(where->value);
+
+   // operands of comparisons are converted once
+   switch(where->op)
+   {  case MY_WHERE_LT:
+      case MY_WHERE_LE:
+      case MY_WHERE_GT:
+      case MY_WHERE_GE:
+         return(my_where_num(where->value, where->value_len, &where->num));
+
+      case MY_WHERE_CIDR:
+         where->family = (strchr(where->value, ':') != NULL) ? AF_INET6 : AF_INET;
+         return(my_where_addr(where->value, where->value_len, where->family, where->addr, &where->bits));
+
+      default:
+         break;
+   };
+
+   return(0);
+}
+
+
+int
+my_where_eval(
+         const my_where_t *            where,
+         const char *                  data,
+         size_t                        len )
+{
+   int               cmp;
+   unsigned          bits;
+   unsigned          pos;
+   my_number_t       num;
+   uint8_t           addr[16];
+
+   switch(where->op)
+   {  case MY_WHERE_EQ:
+         return( (len == where->value_len) && (!(memcmp(data, where->value, len))) );
+
+      case MY_WHERE_NE:
+         return( (len != where->value_len) || ((memcmp(data, where->value, len))) );
+
+      case MY_WHERE_PREFIX:
+         return( (len >= where->value_len) && (!(memcmp(data, where->value, where->value_len))) );
+
+      case MY_WHERE_LT:
+      case MY_WHERE_LE:
+      case MY_WHERE_GT:
+      case MY_WHERE_GE:
+         if (my_where_num(data, len, &num) < 0)
+            return(0);
+         cmp = my_where_numcmp(&num, &where->num);
+         if (where->op == MY_WHERE_LT) return(cmp <  0);
+         if (where->op == MY_WHERE_LE) return(cmp <= 0);
+         if (where->op == MY_WHERE_GT) return(cmp >  0);
+         return(cmp >= 0);
+
+      case MY_WHERE_CIDR:
+         // address or subnet must be contained within network
+         if (my_where_addr(data, len, where->family, addr, &bits) < 0)
+            return(0);
+         if (bits < where->bits)
+            return(0);
+         for(pos = 0; (pos < (where->bits / 8)); pos++)
+            if (addr[pos] != where->addr[pos])
+               return(0);
+         if ((where->bits % 8))
+            if ( ((addr[pos] ^ where->addr[pos]) >> (8 - (where->bits % 8))) != 0 )
+               return(0);
+         return(1);
+
+      default:
+         break;
+   };
+
+   return(0);
+}
+
+
+void
+my_where_free(
+         my_where_t *                  where )
+{
+   if (!(where))
+      return;
+   my_parse_path_free(&where->path);
+   free(where->expr);
+   free(where->value);
+   memset(where, 0, sizeof(my_where_t));
+   return;
+}
+
+
+int
+my_where_num(
+         const char *                  data,
+         size_t                        len,
+         my_number_t *                 num )
+{
+   char              buff[MY_WHERE_NUM_MAX];
+   char *            end;
+
+   if ( (!(len)) || (len >= sizeof(buff)) )
+      return(-EINVAL);
+   memcpy(buff, data, len);
+   buff[len] = '\0';
+
+   // integers are kept exact, such as 64-bit byte and packet counters
+   // which exceed the precision of a double
+   memset(num, 0, sizeof(my_number_t));
+   end   = buff;
+   errno = 0;
+   if ( (buff[0] == '-') && ((isdigit((unsigned char)buff[1]))) )
+   {  num->type = MY_WHERE_SIGNED;
+      num->sval = strtoimax(buff, &end, 10);
+   }
+   else if ((isdigit((unsigned char)buff[0])))
+   {  num->type = MY_WHERE_UNSIGNED;
+      num->uval = strtoumax(buff, &end, 10);
+   };
+   if ( (end != buff) && (!(end[0])) && (errno != ERANGE) )
+      return(0);
+
+   // other values are compared as floating point
+   num->type = MY_WHERE_REAL;
+   num->fval = strtod(buff, &end);
+   if ( (end == buff) || ((end[0])) || (num->fval != num->fval) )
+      return(-EINVAL);
+
+   return(0);
+}
+
+
+int
+my_where_numcmp(
+         const my_number_t *           a,
+         const my_number_t *           b )
+{
+   double            x;
+   double            y;
+
+   // signed integers are only used for negative values
+   if ( (a->type != MY_WHERE_REAL) && (b->type != MY_WHERE_REAL) )
+   {  if (a->type != b->type)
+         return((a->type == MY_WHERE_SIGNED) ? -1 : 1);
+      if (a->type == MY_WHERE_SIGNED)
+         return( (a->sval > b->sval) - (a->sval < b->sval) );
+      return( (a->uval > b->uval) - (a->uval < b->uval) );
+   };
+
+   x = (a->type == MY_WHERE_REAL) ? a->fval : (a->type == MY_WHERE_SIGNED) ? (double)a->sval : (double)a->uval;
+   y = (b->type == MY_WHERE_REAL) ? b->fval : (b->type == MY_WHERE_SIGNED) ? (double)b->sval : (double)b->uval;
+
+   return( (x > y) - (x < y) );
+}
+
+
+/* end of source */
@@ -0,0 +1,365 @@
+/*
+ *  Davici Utilities for Strongswan
+ *  Copyright (C) 2026 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __SRC_DAVICICTL_WRITER_C 1
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include "davicictl.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/uio.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#define MY_WRITER_SLOTS       64
+#define MY_WRITER_SAMPLE_RATE 16
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+#pragma mark - Datatypes
+
+struct _my_writer
+{  int                           fd;
+   int                           policy;
+   atomic_int                    err;
+   atomic_int                    closing;
+   atomic_int                    sleeping;
+   atomic_int                    waiting;
+   atomic_uintmax_t              head;
+   atomic_uintmax_t              tail;
+   atomic_uintmax_t              busy;
+   uintmax_t                     chunks;
+   uintmax_t                     drops;
+   uintmax_t                     dropped;
+   uintmax_t                     high_water;
+   uintmax_t                     sampled;
+   pthread_t                     thread;
+   pthread_mutex_t               lock;
+   pthread_cond_t                ready;
+   pthread_cond_t                space;
+   my_buffer_t                   slots[MY_WRITER_SLOTS];
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static int
+my_writer_free_slot(
+         my_writer_t *                 writer,
+         uintmax_t                     head );
+
+
+static void *
+my_writer_thread(
+         void *                        arg );
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+my_writer_free_slot(
+         my_writer_t *                 writer,
+         uintmax_t                     head )
+{
+   // the slot of the next chunk previously held the chunk `head - SLOTS'
+   // which must be neither queued nor being written by the thread
+   if ((head - atomic_load(&writer->tail)) >= MY_WRITER_SLOTS)
+      return(0);
+   if ( (head >= MY_WRITER_SLOTS) && (atomic_load(&writer->busy) == (head - MY_WRITER_SLOTS + 1)) )
+      return(0);
+   return(1);
+}
+
+
+int
+my_writer_start(
+         my_config_t *                 cnf )
+{
+   int               rc;
+   my_writer_t *     writer;
+
+   if (!(cnf->writer_policy))
+      return(0);
+
+   if ((writer = calloc(1, sizeof(my_writer_t))) == NULL)
+   {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      return(-ENOMEM);
+   };
+   writer->fd     = cnf->out_fd;
+   writer->policy = cnf->writer_policy;
+   atomic_init(&writer->err,        0);
+   atomic_init(&writer->closing,    0);
+   atomic_init(&writer->sleeping,   0);
+   atomic_init(&writer->waiting,    0);
+   atomic_init(&writer->head,       0);
+   atomic_init(&writer->tail,       0);
+   atomic_init(&writer->busy,       0);
+   pthread_mutex_init(&writer->lock, NULL);
+   pthread_cond_init(&writer->ready, NULL);
+   pthread_cond_init(&writer->space, NULL);
+
+   my_verbose(cnf, "starting output writer thread ...\n");
+   if ((rc = pthread_create(&writer->thread, NULL, &my_writer_thread, writer)) != 0)
+   {  fprintf(stderr, "%s: pthread_create(): %s\n", my_prog_name(cnf), strerror(rc));
+      pthread_cond_destroy(&writer->space);
+      pthread_cond_destroy(&writer->ready);
+      pthread_mutex_destroy(&writer->lock);
+      free(writer);
+      return(-rc);
+   };
+   cnf->writer = writer;
+
+   return(0);
+}
+
+
+int
+my_writer_stop(
+         my_config_t *                 cnf )
+{
+   int               rc;
+   size_t            pos;
+   my_writer_t *     writer;
+
+   if ((writer = cnf->writer) == NULL)
+      return(0);
+   cnf->writer = NULL;
+
+   // queued chunks are written before the thread exits
+   pthread_mutex_lock(&writer->lock);
+   atomic_store(&writer->closing, 1);
+   pthread_cond_signal(&writer->ready);
+   pthread_mutex_unlock(&writer->lock);
+   pthread_join(writer->thread, NULL);
+
+   my_verbose(cnf, "output writer: %ju chunks queued, high-water mark %ju of %d slots\n", writer->chunks, writer->high_water, MY_WRITER_SLOTS);
+   if ( ((writer->drops)) && (!(cnf->quiet)) )
+      fprintf(stderr, "%s: output writer dropped %ju chunks (%ju bytes)\n", my_prog_name(cnf), writer->drops, writer->dropped);
+
+   if ( ((rc = atomic_load(&writer->err)) < 0) && (!(cnf->out_err)) )
+   {  fprintf(stderr, "%s: write(): %s\n", my_prog_name(cnf), strerror(-rc));
+      cnf->out_err = rc;
+   };
+
+   for(pos = 0; (pos < MY_WRITER_SLOTS); pos++)
+      my_buffer_free(&writer->slots[pos]);
+   pthread_cond_destroy(&writer->space);
+   pthread_cond_destroy(&writer->ready);
+   pthread_mutex_destroy(&writer->lock);
+   free(writer);
+
+   return(cnf->out_err);
+}
+
+
+void *
+my_writer_thread(
+         void *                        arg )
+{
+   ssize_t           rc;
+   size_t            off;
+   uintmax_t         tail;
+   my_buffer_t *     slot;
+   my_writer_t *     writer;
+
+   writer = arg;
+
+   while(1)
+   {  // wait for queued chunks
+      tail = atomic_load(&writer->tail);
+      if (tail == atomic_load(&writer->head))
+      {  pthread_mutex_lock(&writer->lock);
+         atomic_store(&writer->sleeping, 1);
+         if ( (tail == atomic_load(&writer->head)) && (!(atomic_load(&writer->closing))) )
+            pthread_cond_wait(&writer->ready, &writer->lock);
+         atomic_store(&writer->sleeping, 0);
+         if ( (tail == atomic_load(&writer->head)) && ((atomic_load(&writer->closing))) )
+         {  pthread_mutex_unlock(&writer->lock);
+            break;
+         };
+         pthread_mutex_unlock(&writer->lock);
+         continue;
+      };
+
+      // claim oldest chunk, the claim fails if the chunk was dropped
+      atomic_store(&writer->busy, tail + 1);
+      if (!(atomic_compare_exchange_strong(&writer->tail, &tail, tail + 1)))
+      {  atomic_store(&writer->busy, 0);
+         continue;
+      };
+
+      // chunks are discarded after a write error
+      slot = &writer->slots[tail % MY_WRITER_SLOTS];
+      for(off = 0; ( (off < slot->len) && (!(atomic_load(&writer->err))) ); off += (size_t)rc)
+      {  if ((rc = write(writer->fd, &slot->data[off], (slot->len - off))) >= 0)
+            continue;
+         rc = 0;
+         if (errno != EINTR)
+            atomic_store(&writer->err, -errno);
+      };
+      atomic_store(&writer->busy, 0);
+
+      if ((atomic_load(&writer->waiting)))
+      {  pthread_mutex_lock(&writer->lock);
+         pthread_cond_signal(&writer->space);
+         pthread_mutex_unlock(&writer->lock);
+      };
+   };
+
+   return(NULL);
+}
+
+
+int
+my_writer_writev(
+         my_config_t *                 cnf,
+         struct iovec *                iov,
+         int                           iovcnt )
+{
+   int               rc;
+   int               pos;
+   size_t            len;
+   uintmax_t         head;
+   uintmax_t         tail;
+   char *            ptr;
+   my_buffer_t *     slot;
+   my_writer_t *     writer;
+
+   writer = cnf->writer;
+   head   = atomic_load(&writer->head);
+
+   for(pos = 0, len = 0; (pos < iovcnt); pos++)
+      len += iov[pos].iov_len;
+
+   // apply policy of writer when all slots are in use
+   while (!(my_writer_free_slot(writer, head)))
+   {  if ((rc = atomic_load(&writer->err)) < 0)
+         return(rc);
+      switch(writer->policy)
+      {  case MY_WRITER_BLOCK:
+            pthread_mutex_lock(&writer->lock);
+            atomic_store(&writer->waiting, 1);
+            if (!(my_writer_free_slot(writer, head)))
+               pthread_cond_wait(&writer->space, &writer->lock);
+            atomic_store(&writer->waiting, 0);
+            pthread_mutex_unlock(&writer->lock);
+            continue;
+
+         // only every nth chunk replaces the oldest chunk
+         case MY_WRITER_SAMPLE:
+            if (((++writer->sampled % MY_WRITER_SAMPLE_RATE)))
+            {  writer->drops++;
+               writer->dropped += len;
+               return(0);
+            };
+            // fall through
+
+         // drop oldest queued chunk, the chunk being written by the
+         // thread can not be dropped and the new chunk is dropped instead
+         default:
+            tail = atomic_load(&writer->tail);
+            if ((head - tail) < MY_WRITER_SLOTS)
+            {  writer->drops++;
+               writer->dropped += len;
+               return(0);
+            };
+            if ((atomic_compare_exchange_strong(&writer->tail, &tail, tail + 1)))
+            {  writer->drops++;
+               writer->dropped += writer->slots[tail % MY_WRITER_SLOTS].len;
+            };
+            continue;
+      };
+   };
+   if ((rc = atomic_load(&writer->err)) < 0)
+      return(rc);
+
+   // copy chunk into slot
+   slot        = &writer->slots[head % MY_WRITER_SLOTS];
+   slot->len   = 0;
+   if ((ptr = my_buffer_alloc(slot, len)) == NULL)
+      return(-ENOMEM);
+   for(pos = 0; (pos < iovcnt); pos++)
+   {  memcpy(ptr, iov[pos].iov_base, iov[pos].iov_len);
+      ptr += iov[pos].iov_len;
+   };
+
+   // publish chunk and wake thread
+   atomic_store(&writer->head, head + 1);
+   writer->chunks++;
+   tail = atomic_load(&writer->tail);
+   writer->high_water = ((head + 1 - tail) > writer->high_water) ? (head + 1 - tail) : writer->high_water;
+   if ((atomic_load(&writer->sleeping)))
+   {  pthread_mutex_lock(&writer->lock);
+      pthread_cond_signal(&writer->ready);
+      pthread_mutex_unlock(&writer->lock);
+   };
+
+   return(0);
+}
+
+
+/* end of source */
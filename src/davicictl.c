@@ -52,6 +52,7 @@
 #include <stdlib.h>
 #include <getopt.h>
 #include <signal.h>
+#include <sys/signalfd.h>
 
 #include <davici.h>
 
@@ -63,7 +64,7 @@
 ///////////////////
 // MARK: - Definitions
 
-#define  MY_SOPT              "hO:Pqu:Vv"
+#define  MY_SOPT              "b:d:F:hj:O:o:PQ:qS:u:VvW:w:"
 #define  MY_SOPT_ALL_IKE      "a"
 #define  MY_SOPT_BYPASS       "B"
 #define  MY_SOPT_CHILD        "c:"
@@ -78,19 +79,31 @@
 #define  MY_SOPT_LOGLEVEL     "L:"
 #define  MY_SOPT_NAME         "n:"
 #define  MY_SOPT_NOBLOCK      "N"
+#define  MY_SOPT_PORT         "p:"
 #define  MY_SOPT_REAUTH       "A"
+#define  MY_SOPT_REFRESH      "r:"
 #define  MY_SOPT_TIMEOUT      "t:"
 #define  MY_SOPT_TRAP         "T"
+#define  MY_SOPT_WINDOW       "m:"
 
 
-#define  MY_LOPT              { "help",            no_argument,         NULL, 'h' }, \
+#define  MY_LOPT              { "buffer-size",     required_argument,   NULL, 'b' }, \
+                              { "deadline",        required_argument,   NULL, 'd' }, \
+                              { "fields",          required_argument,   NULL, 'F' }, \
+                              { "help",            no_argument,         NULL, 'h' }, \
+                              { "indent",          required_argument,   NULL, 'w' }, \
+                              { "jobs",            required_argument,   NULL, 'j' }, \
                               { "out-format",      required_argument,   NULL, 'O' }, \
+                              { "output",          required_argument,   NULL, 'o' }, \
                               { "pretty",          no_argument,         NULL, 'P' }, \
+                              { "queue",           required_argument,   NULL, 'Q' }, \
                               { "quiet",           no_argument,         NULL, 'q' }, \
+                              { "select",          required_argument,   NULL, 'S' }, \
                               { "silent",          no_argument,         NULL, 'q' }, \
                               { "socket",          required_argument,   NULL, 'u' }, \
                               { "version",         no_argument,         NULL, 'V' }, \
                               { "verbose",         no_argument,         NULL, 'v' }, \
+                              { "where",           required_argument,   NULL, 'W' }, \
                               { NULL, 0, NULL, 0 }
 #define  MY_LOPT_ALL_IKE      { "all",             no_argument,         NULL, 'a' },
 #define  MY_LOPT_BYPASS       { "bypass",          no_argument,         NULL, 'B' },
@@ -106,9 +119,12 @@
 #define  MY_LOPT_LOGLEVEL     { "loglevel",        required_argument,   NULL, 'L' },
 #define  MY_LOPT_NAME         { "name",            required_argument,   NULL, 'n' },
 #define  MY_LOPT_NOBLOCK      { "noblock",         no_argument,         NULL, 'N' },
+#define  MY_LOPT_PORT         { "port",            required_argument,   NULL, 'p' },
 #define  MY_LOPT_REAUTH       { "reauth",          no_argument,         NULL, 'A' },
+#define  MY_LOPT_REFRESH      { "refresh",         required_argument,   NULL, 'r' },
 #define  MY_LOPT_TIMEOUT      { "name",            required_argument,   NULL, 'n' },
 #define  MY_LOPT_TRAP         { "trap",            no_argument,         NULL, 'T' },
+#define  MY_LOPT_WINDOW       { "window",          required_argument,   NULL, 'm' },
 
 
 //////////////
@@ -143,11 +159,9 @@ main(
          char **                       argv );
 
 
-static int
-my_arguments(
-         my_config_t *                 cnf,
-         int                           argc,
-         char * const *                argv );
+static void
+my_expire(
+         my_config_t *                 cnf );
 
 
 static void
@@ -155,15 +169,9 @@ my_free(
          my_config_t *                 cnf );
 
 
-static my_widget_t *
-my_lookup_widget(
-         const char *                  wname,
-         int                           exact );
-
-
-static void
-my_signal_handler(
-         int                           sig );
+static int
+my_intern_names(
+         my_config_t *                 cnf );
 
 
 static int
@@ -176,19 +184,6 @@ my_version(
          my_config_t *                 cnf );
 
 
-//-------------------//
-// davici prototypes //
-//-------------------//
-#pragma mark davici prototypes
-
-static int
-my_davici_fdcb(
-         struct davici_conn *          conn,
-         int                           fd,
-         int                           ops,
-         void *                        user );
-
-
 //--------------------//
 // widgets prototypes //
 //--------------------//
@@ -217,10 +212,7 @@ my_widget_generic_unload(
 // MARK: - Variables
 
 #pragma mark my_should_exit
-static int my_should_exit = 0;
-
-#pragma mark my_debug
-static int my_debug = 0;
+int my_should_exit = 0;
 
 #pragma mark my_widget_map[]
 static my_widget_t my_widget_map[] =
@@ -241,6 +233,22 @@ static my_widget_t my_widget_map[] =
       .func_usage    = NULL,
    },
 
+   // batch widget
+   {  .name          = "batch",
+      .aliases       = NULL,
+      .desc          = "queues commands read from a file over a single connection",
+      .davici_cmd    = "NONE",
+      .davici_event  = NULL,
+      .flags         = 0,
+      .usage         = "[OPTIONS] [ <file> ]",
+      .short_opt     = MY_SOPT   MY_SOPT_WINDOW,
+      .long_opt      = MY_LOPTS( MY_LOPT_WINDOW ),
+      .arg_min       = 0,
+      .arg_max       = 1,
+      .func_exec     = &my_widget_batch,
+      .func_usage    = NULL,
+   },
+
    // child-updown widget
    {  .name          = "child-updown",
       .aliases       = NULL,
@@ -305,6 +313,22 @@ static my_widget_t my_widget_map[] =
       .func_usage    = NULL,
    },
 
+   // exporter widget
+   {  .name          = "exporter",
+      .aliases       = NULL,
+      .desc          = "serves metrics of the daemon over loopback HTTP",
+      .davici_cmd    = "NONE",
+      .davici_event  = NULL,
+      .flags         = 0,
+      .usage         = "[OPTIONS]",
+      .short_opt     = MY_SOPT   MY_SOPT_PORT MY_SOPT_REFRESH,
+      .long_opt      = MY_LOPTS( MY_LOPT_PORT MY_LOPT_REFRESH ),
+      .arg_min       = 0,
+      .arg_max       = 0,
+      .func_exec     = &my_widget_exporter,
+      .func_usage    = NULL,
+   },
+
    // flush-certs widget (TODO)
    {  .name          = "flush-certs",
       .aliases       = NULL,
@@ -407,7 +431,7 @@ static my_widget_t my_widget_map[] =
       .desc          = "lists loaded pools.",
       .davici_cmd    = "get-pools",
       .davici_event  = NULL,
-      .flags         = 0,
+      .flags         = MY_FLG_RECORDS,
       .usage         = "[OPTIONS]",
       .short_opt     = MY_SOPT MY_SOPT_LEASES MY_SOPT_NAME,
       .long_opt      = MY_LOPTS( MY_LOPT_LEASES MY_LOPT_NAME ),
@@ -519,7 +543,7 @@ static my_widget_t my_widget_map[] =
       .desc          = "Lists loaded certification authorities",
       .davici_cmd    = "list-authorities",
       .davici_event  = "list-authority",
-      .flags         = 0,
+      .flags         = MY_FLG_RECORDS,
       .usage         = "[OPTIONS]",
       .short_opt     = MY_SOPT MY_SOPT_NAME,
       .long_opt      = MY_LOPTS( MY_LOPT_NAME ),
@@ -551,7 +575,7 @@ static my_widget_t my_widget_map[] =
       .desc          = "lists all loaded connections",
       .davici_cmd    = "list-conns",
       .davici_event  = "list-conn",
-      .flags         = 0,
+      .flags         = MY_FLG_RECORDS,
       .usage         = "[OPTIONS]",
       .short_opt     = MY_SOPT MY_SOPT_IKE,
       .long_opt      = MY_LOPTS( MY_LOPT_IKE ),
@@ -567,7 +591,7 @@ static my_widget_t my_widget_map[] =
       .desc          = "lists installed trap, drop and bypass policies",
       .davici_cmd    = "list-policies",
       .davici_event  = "list-policy",
-      .flags         = 0,
+      .flags         = MY_FLG_RECORDS,
       .usage         = "[OPTIONS]",
       .short_opt     = MY_SOPT   MY_SOPT_BYPASS MY_SOPT_CHILD MY_SOPT_DROP MY_SOPT_IKE MY_SOPT_TRAP,
       .long_opt      = MY_LOPTS( MY_LOPT_BYPASS MY_LOPT_CHILD MY_LOPT_DROP MY_LOPT_IKE MY_LOPT_TRAP ),
@@ -583,7 +607,7 @@ static my_widget_t my_widget_map[] =
       .desc          = "lists active IKE_SAs and associated CHILD_SAs",
       .davici_cmd    = "list-sas",
       .davici_event  = "list-sa",
-      .flags         = 0,
+      .flags         = MY_FLG_RECORDS,
       .usage         = "[OPTIONS]",
       .short_opt     = MY_SOPT MY_SOPT_CHILD MY_SOPT_CHILD_ID MY_SOPT_IKE MY_SOPT_IKE_ID MY_SOPT_NOBLOCK,
       .long_opt      = MY_LOPTS( MY_LOPT_CHILD MY_LOPT_CHILD_ID MY_LOPT_IKE MY_LOPT_IKE_ID MY_LOPT_NOBLOCK ),
@@ -975,9 +999,13 @@ main(
          char **                       argv )
 {
    int                        rc;
+   sigset_t                   sigs;
    my_config_t *              cnf;
    const char *               prog_name;
 
+   // select optimized string functions
+   my_simd_init();
+
    // determine program name
    if ((prog_name = strrchr(argv[0], '/')) != NULL)
       prog_name = &prog_name[1];
@@ -995,6 +1023,10 @@ main(
    cnf->prog_name       = prog_name;
    cnf->vici_sockpath   = MY_SOCK_PATH;
    cnf->pollfd.fd       = -1;
+   cnf->epfd            = -1;
+   cnf->timer_fd        = -1;
+   cnf->signal_fd       = -1;
+   cnf->stats.started   = my_time_ns();
 
    // check for symlink alias
    if ((cnf->widget = my_lookup_widget(cnf->prog_name, 1)) != NULL)
@@ -1020,27 +1052,65 @@ main(
       return((rc == -1) ? 0 : 1);
    };
 
-   // set signal handlers
-   signal(SIGHUP,    my_signal_handler);
-   signal(SIGINT,    my_signal_handler);
-   signal(SIGTERM,   my_signal_handler);
-   signal(SIGUSR1,   SIG_IGN);
+   // signals are read from a descriptor by the polling loops instead of
+   // interrupting them, the mask is inherited by threads started below
    signal(SIGUSR2,   SIG_IGN);
    signal(SIGPIPE,   SIG_IGN);
+   sigemptyset(&sigs);
+   sigaddset(&sigs,  SIGHUP);
+   sigaddset(&sigs,  SIGINT);
+   sigaddset(&sigs,  SIGTERM);
+   sigaddset(&sigs,  SIGUSR1);
+   sigprocmask(SIG_BLOCK, &sigs, NULL);
+   if ((cnf->signal_fd = signalfd(-1, &sigs, SFD_NONBLOCK | SFD_CLOEXEC)) == -1)
+   {  fprintf(stderr, "%s: signalfd(): %s\n", my_prog_name(cnf), strerror(errno));
+      my_free(cnf);
+      return(1);
+   };
 
-   // connect to vici socket
-   my_verbose(cnf, "connecting to vici socket ...\n");
-   rc = davici_connect_unix(cnf->vici_sockpath, my_davici_fdcb, cnf, &cnf->davici_conn);
-   if (rc < 0)
-   {  fprintf(stderr, "%s: %s\n", my_prog_name(cnf), strerror(-rc));
+   // allocate output buffer
+   if ((my_out_init(cnf)))
+   {  my_free(cnf);
       return(1);
    };
 
-   rc = cnf->widget->func_exec(cnf);
+   // intern names of known commands and events
+   if ((my_intern_names(cnf)))
+   {  my_free(cnf);
+      return(1);
+   };
 
-   // print footer for specified output format
+   // expand list of vici sockets
+   if ((my_socks_open(cnf)))
+   {  my_free(cnf);
+      return(1);
+   };
+
+   // connect to vici socket
+   if (cnf->socks_len > 1)
+   {  rc = my_socks_exec(cnf);
+   } else
+   {  my_verbose(cnf, "connecting to vici socket ...\n");
+      rc = davici_connect_unix(cnf->vici_sockpath, my_davici_fdcb, cnf, &cnf->davici_conn);
+      if (rc < 0)
+      {  fprintf(stderr, "%s: %s\n", my_prog_name(cnf), strerror(-rc));
+         return(1);
+      };
+      rc = cnf->widget->func_exec(cnf);
+   };
+
+   // print footer for specified output format, output is closed if the
+   // deadline expired before all responses were received
    if (!(rc))
       my_parse_footer(cnf);
+   if ((cnf->socks_err))
+      rc = 1;
+   if ((cnf->expired))
+      rc = MY_EXIT_EXPIRED;
+   if ((my_out_flush(cnf)))
+      rc = 1;
+   if ((my_writer_stop(cnf)))
+      rc = 1;
 
    my_free(cnf);
 
@@ -1056,6 +1126,7 @@ my_arguments(
 {
    int                        c;
    int                        opt_index;
+   char *                     endptr;
    const struct option *      long_opt;
    const char *               short_opt;
    const my_widget_t *        widget;
@@ -1088,6 +1159,15 @@ my_arguments(
             cnf->flags |= MY_FLG_POLS_BYPASS;
             break;
 
+         case 'b':
+            cnf->out_threshold = (size_t)strtoul(optarg, &endptr, 0);
+            if ( ((endptr[0])) || (cnf->out_threshold < MY_OUT_BUFF_MIN) )
+            {  fprintf(stderr, "%s: invalid buffer size `%s'\n", my_prog_name(cnf), optarg);
+               fprintf(stderr, "Try `%s --help' for more information.\n",  my_prog_name(cnf));
+               return(1);
+            };
+            break;
+
          case 'C':
             cnf->child_sa_id = optarg;
             break;
@@ -1100,6 +1180,15 @@ my_arguments(
             cnf->flags |= MY_FLG_POLS_DROP;
             break;
 
+         case 'd':
+            cnf->opt_deadline = (unsigned)strtoul(optarg, &endptr, 10);
+            if ( ((endptr[0])) || (!(cnf->opt_deadline)) )
+            {  fprintf(stderr, "%s: invalid deadline `%s'\n", my_prog_name(cnf), optarg);
+               fprintf(stderr, "Try `%s --help' for more information.\n",  my_prog_name(cnf));
+               return(1);
+            };
+            break;
+
          case 'E':
             cnf->alt_event = optarg;
             break;
@@ -1108,6 +1197,10 @@ my_arguments(
             cnf->alt_command = optarg;
             break;
 
+         case 'F':
+            cnf->opt_fields = optarg;
+            break;
+
          case 'f':
             cnf->flags |= MY_FLG_FORCE;
             break;
@@ -1124,6 +1217,15 @@ my_arguments(
             cnf->ike_sa = optarg;
             break;
 
+         case 'j':
+            cnf->opt_jobs = (unsigned)strtoul(optarg, &endptr, 10);
+            if ( ((endptr[0])) || (!(cnf->opt_jobs)) || (cnf->opt_jobs > MY_JOBS_MAX) )
+            {  fprintf(stderr, "%s: invalid number of jobs `%s'\n", my_prog_name(cnf), optarg);
+               fprintf(stderr, "Try `%s --help' for more information.\n",  my_prog_name(cnf));
+               return(1);
+            };
+            break;
+
          case 'l':
             cnf->flags |= MY_FLG_LEASES;
             break;
@@ -1132,6 +1234,15 @@ my_arguments(
             cnf->opt_loglevel = optarg;
             break;
 
+         case 'm':
+            cnf->opt_window = (unsigned)strtoul(optarg, &endptr, 10);
+            if ( ((endptr[0])) || (!(cnf->opt_window)) )
+            {  fprintf(stderr, "%s: invalid window `%s'\n", my_prog_name(cnf), optarg);
+               fprintf(stderr, "Try `%s --help' for more information.\n",  my_prog_name(cnf));
+               return(1);
+            };
+            break;
+
          case 'N':
             cnf->flags |= MY_FLG_NOBLOCK;
             break;
@@ -1141,8 +1252,15 @@ my_arguments(
             break;
 
          case 'O':
-            if      (!(strcasecmp(optarg, "debug"))) cnf->format_out = MY_FMT_DEBUG;
+            if      (!(strcasecmp(optarg, "arrow"))) cnf->format_out = MY_FMT_ARROW;
+            else if (!(strcasecmp(optarg, "cbor")))  cnf->format_out = MY_FMT_CBOR;
+            else if (!(strcasecmp(optarg, "csv")))   cnf->format_out = MY_FMT_CSV;
+            else if (!(strcasecmp(optarg, "debug"))) cnf->format_out = MY_FMT_DEBUG;
             else if (!(strcasecmp(optarg, "json")))  cnf->format_out = MY_FMT_JSON;
+            else if (!(strcasecmp(optarg, "msgpack"))) cnf->format_out = MY_FMT_MSGPACK;
+            else if (!(strcasecmp(optarg, "ndjson"))) cnf->format_out = MY_FMT_NDJSON;
+            else if (!(strcasecmp(optarg, "openmetrics"))) cnf->format_out = MY_FMT_OPENMETRICS;
+            else if (!(strcasecmp(optarg, "tsv")))   cnf->format_out = MY_FMT_TSV;
             else if (!(strcasecmp(optarg, "xml")))   cnf->format_out = MY_FMT_XML;
             else if (!(strcasecmp(optarg, "vici")))  cnf->format_out = MY_FMT_VICI;
             else if (!(strcasecmp(optarg, "yaml")))  cnf->format_out = MY_FMT_YAML;
@@ -1153,10 +1271,34 @@ my_arguments(
             };
             break;
 
+         case 'o':
+            cnf->opt_output = optarg;
+            break;
+
          case 'P':
             cnf->flags |= MY_FLG_PRETTY;
             break;
 
+         case 'p':
+            cnf->opt_port = (unsigned)strtoul(optarg, &endptr, 10);
+            if ( ((endptr[0])) || (!(cnf->opt_port)) || (cnf->opt_port > 65535) )
+            {  fprintf(stderr, "%s: invalid port `%s'\n", my_prog_name(cnf), optarg);
+               fprintf(stderr, "Try `%s --help' for more information.\n",  my_prog_name(cnf));
+               return(1);
+            };
+            break;
+
+         case 'Q':
+            if      (!(strcasecmp(optarg, "block")))  cnf->writer_policy = MY_WRITER_BLOCK;
+            else if (!(strcasecmp(optarg, "drop")))   cnf->writer_policy = MY_WRITER_DROP;
+            else if (!(strcasecmp(optarg, "sample"))) cnf->writer_policy = MY_WRITER_SAMPLE;
+            else
+            {  fprintf(stderr, "%s: unsupported queue mode `%s'\n", my_prog_name(cnf), optarg);
+               fprintf(stderr, "Try `%s --help' for more information.\n",  my_prog_name(cnf));
+               return(1);
+            };
+            break;
+
          case 'q':
             cnf->quiet = 1;
             if ((cnf->verbose))
@@ -1166,6 +1308,23 @@ my_arguments(
             };
             break;
 
+         case 'r':
+            cnf->opt_refresh = (unsigned)strtoul(optarg, &endptr, 10);
+            if ( ((endptr[0])) || (!(cnf->opt_refresh)) )
+            {  fprintf(stderr, "%s: invalid refresh interval `%s'\n", my_prog_name(cnf), optarg);
+               fprintf(stderr, "Try `%s --help' for more information.\n",  my_prog_name(cnf));
+               return(1);
+            };
+            break;
+
+         case 'S':
+            cnf->opt_select = optarg;
+            if (my_parse_select(cnf) < 0)
+            {  fprintf(stderr, "Try `%s --help' for more information.\n",  my_prog_name(cnf));
+               return(1);
+            };
+            break;
+
          case 'T':
             cnf->flags |= MY_FLG_POLS_TRAP;
             break;
@@ -1191,6 +1350,22 @@ my_arguments(
             };
             break;
 
+         case 'W':
+            if (my_parse_where(cnf, optarg) < 0)
+            {  fprintf(stderr, "Try `%s --help' for more information.\n",  my_prog_name(cnf));
+               return(1);
+            };
+            break;
+
+         case 'w':
+            cnf->out_indent = (size_t)strtoul(optarg, &endptr, 10);
+            if ( ((endptr[0])) || (!(cnf->out_indent)) || (cnf->out_indent > MY_OUT_INDENT_MAX) )
+            {  fprintf(stderr, "%s: invalid indentation width `%s'\n", my_prog_name(cnf), optarg);
+               fprintf(stderr, "Try `%s --help' for more information.\n",  my_prog_name(cnf));
+               return(1);
+            };
+            break;
+
          case '?':
             fprintf(stderr, "Try `%s --help' for more information.\n", my_prog_name(cnf));
             return(1);
@@ -1229,6 +1404,29 @@ my_arguments(
 }
 
 
+void
+my_expire(
+         my_config_t *                 cnf )
+{
+   // stream of events ends at the deadline
+   if (!(cnf->queued))
+   {  my_verbose(cnf, "deadline of %u ms expired ...\n", cnf->opt_deadline);
+      return;
+   };
+
+   // requests which are outstanding at the deadline are abandoned by
+   // disconnecting from the vici socket
+   fprintf(stderr, "%s: deadline of %u ms expired (outstanding requests: %d)\n", my_prog_name(cnf), cnf->opt_deadline, cnf->queued);
+   cnf->expired = 1;
+   my_verbose(cnf, "disconnecting from vici socket ...\n");
+   davici_disconnect(cnf->davici_conn);
+   cnf->davici_conn  = NULL;
+   cnf->pollfd.fd    = -1;
+
+   return;
+}
+
+
 void
 my_free(
          my_config_t *                 cnf )
@@ -1241,12 +1439,61 @@ my_free(
       davici_disconnect(cnf->davici_conn);
    };
 
+   my_jobs_stop(cnf);
+   my_socks_free(cnf);
+   if (cnf->timer_fd != -1)
+      close(cnf->timer_fd);
+   my_out_free(cnf);
+   if (cnf->signal_fd != -1)
+      close(cnf->signal_fd);
+   my_buffer_free(&cnf->msg_buff);
+   my_buffer_free(&cnf->msg_stack);
+   my_buffer_free(&cnf->sects);
+   my_buffer_free(&cnf->sects_offs);
+   my_parse_free(cnf);
+
    free(cnf);
 
    return;
 }
 
 
+int
+my_intern_names(
+         my_config_t *                 cnf )
+{
+   int               x;
+   const char *      name;
+
+   // names of messages are interned before the first message is parsed
+   // so that tracking consecutive messages does not allocate
+   for(x = 0; ((my_widget_map[x].name)); x++)
+   {  name = my_widget_map[x].davici_cmd;
+      if ( ((name)) && ((strcmp(name, "NONE"))) && (my_parse_intern(cnf, name) < 0) )
+         break;
+      name = my_widget_map[x].davici_event;
+      if ( ((name)) && (my_parse_intern(cnf, name) < 0) )
+         break;
+   };
+   if ((my_widget_map[x].name))
+   {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      return(1);
+   };
+
+   // names queued by the raw widget
+   if ( ((cnf->alt_command)) && (my_parse_intern(cnf, cnf->alt_command) < 0) )
+   {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      return(1);
+   };
+   if ( ((cnf->alt_event)) && (my_parse_intern(cnf, cnf->alt_event) < 0) )
+   {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      return(1);
+   };
+
+   return(0);
+}
+
+
 my_widget_t *
 my_lookup_widget(
          const char *                  wname,
@@ -1323,12 +1570,35 @@ int
 my_poll(
          my_config_t *                 cnf )
 {
-   int rc;
+   int               rc;
+   struct pollfd     pfds[3];
+
+   // requests queued on multiple sockets are polled by my_socks_exec()
+   // and requests of batched commands by my_widget_batch()
+   if ( ((cnf->sock)) || ((cnf->batch)) )
+      return(0);
+
+   // responses to queued requests are awaited until the deadline
+   if ( ((cnf->opt_deadline)) && (cnf->timer_fd == -1) )
+      if ((cnf->timer_fd = my_deadline_start(cnf)) == -1)
+         return(1);
 
    // poll for responses
    my_verbose(cnf, "entering polling loop ...\n");
+   cnf->stats.queued = my_time_ns();
    while ( (!(my_should_exit)) && (cnf->pollfd.fd != -1) )
-   {  if ((rc = poll(&cnf->pollfd, 1, 30000)) < 0)
+   {  // write formatted responses before waiting for more data
+      if ((my_out_flush(cnf)))
+         return(1);
+
+      pfds[0]           = cnf->pollfd;
+      pfds[1].fd        = cnf->timer_fd;
+      pfds[1].events    = POLLIN;
+      pfds[1].revents   = 0;
+      pfds[2].fd        = cnf->signal_fd;
+      pfds[2].events    = POLLIN;
+      pfds[2].revents   = 0;
+      if ((rc = poll(pfds, 3, 30000)) < 0)
       {  switch(errno)
          {  case EINTR: break;
 
@@ -1341,14 +1611,23 @@ my_poll(
       };
       if (!(rc))
          continue;
-      if ((cnf->pollfd.revents & POLLIN))
+      if ((pfds[2].revents & POLLIN))
+      {  my_signal(cnf);
+         if ((my_should_exit))
+            break;
+      };
+      if ((pfds[1].revents & POLLIN))
+      {  my_expire(cnf);
+         break;
+      };
+      if ((pfds[0].revents & POLLIN))
       {  my_verbose(cnf, "reading data from vici socket ...\n");
          if ((rc = davici_read(cnf->davici_conn)) < 0)
          {  fprintf(stderr, "%s: davici_read(): %s\n", my_prog_name(cnf), strerror(-rc));
             return(1);
          };
       };
-      if ((cnf->pollfd.revents & POLLOUT))
+      if ((pfds[0].revents & POLLOUT))
       {  my_verbose(cnf, "writing data to vici socket ...\n");
          if ((rc = davici_write(cnf->davici_conn)) < 0)
          {  fprintf(stderr, "%s: davici_write(): %s\n", my_prog_name(cnf), strerror(-rc));
@@ -1385,19 +1664,40 @@ my_prog_name(
 
 
 void
-my_signal_handler(
-         int                           sig )
+my_signal(
+         my_config_t *                 cnf )
 {
-   my_should_exit = 1;
-   if ((my_debug))
-   {  switch(sig)
-      {  case SIGHUP:   printf("%s: caught SIGHUP signal\n",  PROGRAM_NAME); break;
-         case SIGINT:   printf("%s: caught SIGINT signal\n",  PROGRAM_NAME); break;
-         case SIGTERM:  printf("%s: caught SIGTERM signal\n", PROGRAM_NAME); break;
-         default:       printf("%s: caught unknown signal\n", PROGRAM_NAME); break;
+   struct signalfd_siginfo    info;
+
+   while (read(cnf->signal_fd, &info, sizeof(info)) == (ssize_t)sizeof(info))
+   {  switch(info.ssi_signo)
+      {  case SIGHUP:
+            // output file is reopened after it was rotated
+            if ((cnf->opt_output))
+            {  my_verbose(cnf, "caught SIGHUP signal, reopening %s ...\n", cnf->opt_output);
+               my_out_reopen(cnf);
+               break;
+            };
+            my_verbose(cnf, "caught SIGHUP signal ...\n");
+            my_should_exit = 1;
+            break;
+
+         case SIGINT:
+         case SIGTERM:
+            // polling loops stop reading and the output is drained
+            my_verbose(cnf, "caught %s signal, draining output ...\n", (info.ssi_signo == SIGINT) ? "SIGINT" : "SIGTERM");
+            my_should_exit = 1;
+            break;
+
+         case SIGUSR1:
+            my_stats_dump(cnf);
+            break;
+
+         default:
+            break;
       };
    };
-   signal(sig, my_signal_handler);
+
    return;
 }
 
@@ -1437,27 +1737,39 @@ my_usage(
    if ((strchr(short_opt, 'A'))) printf("  -A,        --reauth          reauthenticate instead of rekey an IKEv2 SA\n");
    if ((strchr(short_opt, 'a'))) printf("  -a,        --all             all IKE connections and IKE SA\n");
    if ((strchr(short_opt, 'B'))) printf("  -B,        --bypass          list bypass policies\n");
+   if ((strchr(short_opt, 'b'))) printf("  -b num,    --buffer-size=num output buffer size in bytes\n");
    if ((strchr(short_opt, 'C'))) printf("  -C id,     --child-id=id     filter child by unique identifier\n");
    if ((strchr(short_opt, 'c'))) printf("  -c name,   --child=name      filter child SA or child connection by name\n");
    if ((strchr(short_opt, 'D'))) printf("  -D,        --drop            list drop policies\n");
+   if ((strchr(short_opt, 'd'))) printf("  -d ms,     --deadline=ms     milliseconds to wait for responses to requests\n");
    if ((strchr(short_opt, 'E'))) printf("  -E str,    --event=str       vici event to register\n");
    if ((strchr(short_opt, 'e'))) printf("  -e str,    --command=str     vici command to queue\n");
+   if ((strchr(short_opt, 'F'))) printf("  -F list,   --fields=list     dotted paths of columns for csv and tsv output\n");
    if ((strchr(short_opt, 'f'))) printf("  -f,        --force           terminate IKE SA immediately unless using timeout\n");
    if ((strchr(short_opt, 'h'))) printf("  -h,        --help            print this help and exit\n");
    if ((strchr(short_opt, 'I'))) printf("  -I id,     --ike-id=id       filter IKE SA by unique identifier\n");
    if ((strchr(short_opt, 'i'))) printf("  -i name,   --ike=name        filter IKE SA or IKE connection by name\n");
+   if ((strchr(short_opt, 'j'))) printf("  -j num,    --jobs=num        number of threads formatting records\n");
    if ((strchr(short_opt, 'L'))) printf("  -L level,  --loglevel=level  verbosity of log\n");
    if ((strchr(short_opt, 'l'))) printf("  -l,        --leases          list leases of each pool\n");
+   if ((strchr(short_opt, 'm'))) printf("  -m num,    --window=num      maximum number of batched commands awaiting responses\n");
    if ((strchr(short_opt, 'N'))) printf("  -N,        --noblock         don't wait for IKE_SAs in use\n");
    if ((strchr(short_opt, 'n'))) printf("  -n str,    --name=str        filter by name\n");
-   if ((strchr(short_opt, 'O'))) printf("  -O fmt,    --out-format=fmt  output format (json, vici, xml, or yaml)\n");
+   if ((strchr(short_opt, 'O'))) printf("  -O fmt,    --out-format=fmt  output format (arrow, cbor, csv, json, msgpack, ndjson, openmetrics, tsv, vici, xml, or yaml)\n");
+   if ((strchr(short_opt, 'o'))) printf("  -o file,   --output=file     append output to file, reopened on SIGHUP\n");
    if ((strchr(short_opt, 'P'))) printf("  -P,        --pretty          beautify response messages\n");
+   if ((strchr(short_opt, 'p'))) printf("  -p port,   --port=port       loopback TCP port of HTTP listener\n");
+   if ((strchr(short_opt, 'Q'))) printf("  -Q mode,   --queue=mode      write output from a thread (block, drop, or sample)\n");
    if ((strchr(short_opt, 'q'))) printf("  -q,        --quiet, --silent do not print messages\n");
+   if ((strchr(short_opt, 'r'))) printf("  -r sec,    --refresh=sec     seconds between queries of the daemon\n");
+   if ((strchr(short_opt, 'S'))) printf("  -S list,   --select=list     dotted paths of elements to display\n");
    if ((strchr(short_opt, 'T'))) printf("  -T,        --trap            list trap policies\n");
    if ((strchr(short_opt, 't'))) printf("  -t ms,     --timeout=ms      timeout in milliseconds before detaching\n");
-   if ((strchr(short_opt, 'u'))) printf("  -u path,   --socket=path     path to vici socket\n");
+   if ((strchr(short_opt, 'u'))) printf("  -u path,   --socket=path     comma separated paths or patterns of vici sockets\n");
    if ((strchr(short_opt, 'V'))) printf("  -V,        --version         print version number and exit\n");
    if ((strchr(short_opt, 'v'))) printf("  -v,        --verbose         print verbose messages\n");
+   if ((strchr(short_opt, 'W'))) printf("  -W expr,   --where=expr      display messages matching expression\n");
+   if ((strchr(short_opt, 'w'))) printf("  -w num,    --indent=num      number of spaces per level of beautified output\n");
    if (!(cnf->widget))
    {  printf("WIDGETS:\n");
       for(pos = 0; my_widget_map[pos].name != NULL; pos++)
@@ -1521,6 +1833,7 @@ my_davici_cb_command(
          void *                        user )
 {
    int            rc;
+   uint64_t       started;
    my_config_t *  cnf;
 
    if (!(conn))
@@ -1528,12 +1841,24 @@ my_davici_cb_command(
 
    cnf = (my_config_t *)user;
 
+   // responses to requests abandoned at the deadline are ignored
+   if ( (!(cnf->sock)) && ((cnf->expired)) )
+      return;
+   if ( ((cnf->sock)) && ((cnf->sock->err)) )
+      return;
+
    my_verbose(cnf, "processing results of \"%s\" command ...\n", name);
 
    cnf->queued--;
-   if (cnf->queued <= 0)
+   if ((cnf->sock))
+      cnf->sock->queued--;
+   if ( (cnf->queued <= 0) && (!(cnf->batch)) )
       my_should_exit = 1;
 
+   if ( (err < 0) && ((cnf->sock)) )
+   {  my_socks_fail(cnf, name, err);
+      return;
+   };
    if (err < 0)
    {  fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, name, strerror(-err));
       my_should_exit = err;
@@ -1543,7 +1868,9 @@ my_davici_cb_command(
    if (!(res))
       return;
 
-   rc = my_parse_res(name, res, cnf, 0);
+   started  = my_time_ns();
+   rc       = my_parse_res(name, res, cnf, 0);
+   my_stats_message(cnf, started, 1);
    if (rc < 0)
    {  fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, name, strerror(-rc));
       my_should_exit = rc;
@@ -1563,6 +1890,7 @@ my_davici_cb_event(
          void *                        user )
 {
    int               rc;
+   uint64_t          started;
    my_config_t *     cnf;
 
    if (!(conn))
@@ -1570,8 +1898,17 @@ my_davici_cb_event(
 
    cnf = (my_config_t *)user;
 
+   if ( (!(cnf->sock)) && ((cnf->expired)) )
+      return;
+   if ( ((cnf->sock)) && ((cnf->sock->err)) )
+      return;
+
    my_verbose(cnf, "processing results of \"%s\" event ...\n", name);
 
+   if ( (err < 0) && ((cnf->sock)) )
+   {  my_socks_fail(cnf, name, err);
+      return;
+   };
    if (err < 0)
    {  fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, name, strerror(-err));
       my_should_exit = err;
@@ -1581,7 +1918,9 @@ my_davici_cb_event(
    if (!(res))
       return;
 
-   rc = my_parse_res(name, res, cnf, 1);
+   started  = my_time_ns();
+   rc       = my_parse_res(name, res, cnf, 1);
+   my_stats_message(cnf, started, 0);
    if (rc < 0)
    {  fprintf(stderr, "%s: %s: %s\n", PROGRAM_NAME, name, strerror(-rc));
       my_should_exit = rc;
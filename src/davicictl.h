@@ -55,6 +55,7 @@
 #include <davici.h>
 #include <poll.h>
 #include <inttypes.h>
+#include <sys/uio.h>
 
 
 //////////////
@@ -64,6 +65,9 @@
 //////////////
 // MARK: - Macros
 
+#undef   MY_BASE64_LEN
+#define  MY_BASE64_LEN(n)     ((((n) + 2) / 3) * 4)
+
 
 ///////////////////
 //               //
@@ -91,6 +95,10 @@
 #   define PACKAGE_VERSION ""
 #endif
 
+#if defined(HAVE_IMMINTRIN_H) && defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#   define MY_USE_X86_SIMD 1
+#endif
+
 #undef MY_SOCK_PATH
 #define MY_SOCK_PATH          "/var/run/charon.vici"
 
@@ -104,6 +112,7 @@
 #define MY_FLG_POLS_BYPASS    0x00000080
 #define MY_FLG_POLS_TRAP      0x00000100
 #define MY_FLG_REAUTH         0x00000200
+#define MY_FLG_RECORDS        0x00000400
 
 #define MY_FMT_DEFAULT        0x00000000
 #define MY_FMT_DEBUG          0x00000001
@@ -111,6 +120,53 @@
 #define MY_FMT_JSON           0x00000003
 #define MY_FMT_YAML           0x00000004
 #define MY_FMT_XML            0x00000005
+#define MY_FMT_NDJSON         0x00000006
+#define MY_FMT_CBOR           0x00000007
+#define MY_FMT_MSGPACK        0x00000008
+#define MY_FMT_ARROW          0x00000009
+#define MY_FMT_CSV            0x0000000a
+#define MY_FMT_TSV            0x0000000b
+#define MY_FMT_OPENMETRICS    0x0000000c
+
+// returned by section and list callbacks of an emitter to skip the subtree
+#define MY_EMIT_SKIP          1
+
+// emitter shares a section among consecutive messages with the same name
+#define MY_EMIT_MERGE         0x00000001
+// emitter writes the top level sections of messages as rows
+#define MY_EMIT_ROWS          0x00000002
+
+#define MY_WHERE_EQ           1
+#define MY_WHERE_NE           2
+#define MY_WHERE_PREFIX       3
+#define MY_WHERE_LT           4
+#define MY_WHERE_LE           5
+#define MY_WHERE_GT           6
+#define MY_WHERE_GE           7
+#define MY_WHERE_CIDR         8
+
+#define MY_BASE64_CHUNK       (3*1024)
+#define MY_BUFF_SIZE          4096
+#define MY_OUT_BUFF_SIZE      (64*1024)
+#define MY_OUT_BUFF_MIN       512
+#define MY_OUT_INDENT         3
+#define MY_OUT_INDENT_MAX     16
+#define MY_OUT_SLAB_SIZE      1024
+
+#define MY_OUT_DELIM_NONE     0
+#define MY_OUT_DELIM_NEWLINE  1
+#define MY_OUT_DELIM_COMMA    2
+
+#define MY_WRITER_NONE        0
+#define MY_WRITER_BLOCK       1
+#define MY_WRITER_DROP        2
+#define MY_WRITER_SAMPLE      3
+
+#define MY_JOBS_MAX           64
+
+// exit status if requests are outstanding once the deadline expires, which
+// matches the exit status of timeout(1)
+#define MY_EXIT_EXPIRED       124
 
 
 //////////////////
@@ -120,8 +176,41 @@
 //////////////////
 // MARK: - Data Types
 
+typedef struct _my_backlog    my_backlog_t;
+typedef struct _my_batch      my_batch_t;
+typedef struct _my_buffer     my_buffer_t;
 typedef struct _my_config     my_config_t;
+typedef struct _my_emitter    my_emitter_t;
+typedef struct _my_jobs       my_jobs_t;
+typedef struct _my_name       my_name_t;
+typedef struct _my_number     my_number_t;
+typedef struct _my_path       my_path_t;
+typedef struct _my_sock       my_sock_t;
+typedef struct _my_stats      my_stats_t;
+typedef struct _my_value      my_value_t;
+typedef struct _my_where      my_where_t;
 typedef struct _my_widget     my_widget_t;
+typedef struct _my_writer     my_writer_t;
+
+
+struct _my_buffer
+{  char *                        data;
+   size_t                        len;
+   size_t                        size;
+};
+
+
+struct _my_stats
+{  uintmax_t                     messages;
+   uintmax_t                     replies;
+   uintmax_t                     bytes;
+   uint64_t                      started;
+   uint64_t                      queued;
+   uint64_t                      format_total;
+   uint64_t                      format_max;
+   uint64_t                      reply_total;
+   uint64_t                      reply_max;
+};
 
 
 struct _my_config
@@ -133,11 +222,53 @@ struct _my_config
    int                           flags;
    int                           format_out;
    int                           last_was_item;
+   int                           out_fd;
+   int                           out_err;
+   int                           writer_policy;
+   int                           timer_fd;
+   int                           signal_fd;
+   int                           expired;
+   size_t                        out_threshold;
+   size_t                        out_indent;
+   char *                        out_slab;
+   my_buffer_t                   out;
+   my_buffer_t                   msg_buff;
+   my_buffer_t                   msg_stack;
+   my_buffer_t                   path;
+   my_buffer_t                   path_offs;
+   my_buffer_t                   tape;
+   my_buffer_t                   tape_data;
+   my_buffer_t                   replay_path;
+   my_buffer_t                   replay_offs;
+   my_buffer_t                   sects;
+   my_buffer_t                   sects_offs;
+   my_buffer_t *                 out_capture;
+   my_writer_t *                 writer;
+   my_jobs_t *                   jobs;
+   my_batch_t *                  batch;
+   my_sock_t *                   sock;
+   my_sock_t *                   socks;
+   size_t                        socks_len;
+   size_t                        socks_err;
+   int                           epfd;
    struct pollfd                 pollfd;
+   my_stats_t                    stats;
+   unsigned                      opt_deadline;
+   unsigned                      opt_jobs;
+   unsigned                      opt_port;
+   unsigned                      opt_refresh;
+   unsigned                      opt_window;
    char * const *                argv;
    const char *                  prog_name;
    const char *                  vici_sockpath;
-   char *                        res_last_name;
+   unsigned                      res_id;
+   unsigned                      res_last_id;
+   my_sock_t *                   res_last_sock;
+   size_t                        res_count;
+   my_name_t *                   names;
+   size_t                        names_size;
+   size_t                        names_len;
+   my_buffer_t                   names_data;
    const char *                  alt_command;
    const char *                  alt_event;
    const char *                  ike_sa;
@@ -147,12 +278,95 @@ struct _my_config
    const char *                  opt_name;
    const char *                  opt_timeout;
    const char *                  opt_loglevel;
+   const char *                  opt_fields;
+   const char *                  opt_output;
+   const char *                  opt_select;
    const my_widget_t *           widget;
+   const my_emitter_t *          emitter;
+   void *                        emitter_state;
+   my_path_t *                   select;
+   size_t                        select_len;
+   size_t                        select_depth;
+   my_where_t *                  where;
+   size_t                        where_len;
+   int                           where_state;
+   size_t                        hide_depth;
    struct davici_conn *          davici_conn;
    struct davici_request *       davici_req;
 };
 
 
+struct _my_emitter
+{  int                        format;
+   int                        flags;
+   int  (*func_footer)(my_config_t * cnf);
+   int  (*func_key_value)(my_config_t * cnf, unsigned level, const char * key, const my_value_t * val);
+   int  (*func_list_end)(my_config_t * cnf, unsigned level);
+   int  (*func_list_item)(my_config_t * cnf, unsigned level, const my_value_t * val);
+   int  (*func_list_start)(my_config_t * cnf, unsigned level, const char * key);
+   int  (*func_msg_end)(my_config_t * cnf, unsigned level, const char * name, int is_event);
+   int  (*func_msg_start)(my_config_t * cnf, const char * name, int is_event);
+   int  (*func_sect_end)(my_config_t * cnf, unsigned level);
+   int  (*func_sect_start)(my_config_t * cnf, unsigned level, const char * key);
+};
+
+
+struct _my_name
+{  uint32_t                      hash;
+   unsigned                      id;
+   size_t                        off;
+};
+
+
+struct _my_number
+{  int                           type;
+   intmax_t                      sval;
+   uintmax_t                     uval;
+   double                        fval;
+};
+
+
+struct _my_path
+{  char *                        spec;
+   char **                       segs;
+   size_t                        nsegs;
+};
+
+
+struct _my_sock
+{  int                           fd;
+   int                           timer_fd;
+   int                           err;
+   int                           queued;
+   char *                        path;
+   my_config_t *                 cnf;
+   my_backlog_t *                backlog;
+   size_t                        backlog_len;
+   struct davici_conn *          conn;
+};
+
+
+struct _my_value
+{  const char *                  data;
+   size_t                        len;
+   int                           is_binary;
+};
+
+
+struct _my_where
+{  my_path_t                     path;
+   int                           op;
+   int                           family;
+   int                           state;
+   unsigned                      bits;
+   uint8_t                       addr[16];
+   my_number_t                   num;
+   char *                        expr;
+   char *                        value;
+   size_t                        value_len;
+};
+
+
 struct _my_widget
 {  const char *               name;
    const char *               desc;
@@ -178,6 +392,21 @@ struct _my_widget
 /////////////////
 // MARK: - Variables
 
+extern const my_emitter_t my_emitter_arrow;
+extern const my_emitter_t my_emitter_cbor;
+extern const my_emitter_t my_emitter_csv;
+extern const my_emitter_t my_emitter_debug;
+extern const my_emitter_t my_emitter_json;
+extern const my_emitter_t my_emitter_msgpack;
+extern const my_emitter_t my_emitter_tsv;
+extern const my_emitter_t my_emitter_ndjson;
+extern const my_emitter_t my_emitter_openmetrics;
+extern const my_emitter_t my_emitter_vici;
+extern const my_emitter_t my_emitter_xml;
+extern const my_emitter_t my_emitter_yaml;
+
+extern int my_should_exit;
+
 
 //////////////////
 //              //
@@ -186,6 +415,19 @@ struct _my_widget
 //////////////////
 // MARK: - Prototypes
 
+extern int
+my_arguments(
+         my_config_t *                 cnf,
+         int                           argc,
+         char * const *                argv );
+
+
+extern my_widget_t *
+my_lookup_widget(
+         const char *                  wname,
+         int                           exact );
+
+
 extern int
 my_poll(
          my_config_t *                 cnf );
@@ -196,6 +438,11 @@ my_prog_name(
          my_config_t *                 cnf );
 
 
+extern void
+my_signal(
+         my_config_t *                 cnf );
+
+
 extern void
 my_verbose(
          my_config_t *                 cnf,
@@ -226,6 +473,37 @@ my_davici_cb_event(
          void *                        user );
 
 
+extern int
+my_davici_fdcb(
+         struct davici_conn *          conn,
+         int                           fd,
+         int                           ops,
+         void *                        user );
+
+
+//-----------------//
+// jobs prototypes //
+//-----------------//
+#pragma mark jobs prototypes
+
+extern int
+my_jobs_drain(
+         my_config_t *                 cnf );
+
+
+extern void
+my_jobs_stop(
+         my_config_t *                 cnf );
+
+
+extern int
+my_jobs_submit(
+         my_config_t *                 cnf,
+         const char *                  name,
+         struct davici_response *      res,
+         int                           is_event );
+
+
 //--------------------------//
 // miscellaneous prototypes //
 //--------------------------//
@@ -239,6 +517,44 @@ my_base64_encode(
          size_t                        n );
 
 
+extern void *
+my_buffer_alloc(
+         my_buffer_t *                 buff,
+         size_t                        len );
+
+
+extern void
+my_buffer_free(
+         my_buffer_t *                 buff );
+
+
+extern int
+my_deadline_start(
+         my_config_t *                 cnf );
+
+
+extern size_t
+my_json_escape_span(
+         const void *                  src,
+         size_t                        n );
+
+
+extern void
+my_simd_init( void );
+
+
+extern void
+my_stats_dump(
+         my_config_t *                 cnf );
+
+
+extern void
+my_stats_message(
+         my_config_t *                 cnf,
+         uint64_t                      started,
+         int                           is_reply );
+
+
 size_t
 my_strlcat(
          char * restrict               dst,
@@ -253,16 +569,176 @@ my_strlcpy(
          size_t                        dstsize );
 
 
+extern uint64_t
+my_time_ns( void );
+
+
+extern int
+my_utf8_is_text(
+         const void *                  src,
+         size_t                        n );
+
+
+extern size_t
+my_xml_escape_span(
+         const void *                  src,
+         size_t                        n );
+
+
+//-------------------//
+// output prototypes //
+//-------------------//
+#pragma mark output prototypes
+
+extern int
+my_out_base64(
+         my_config_t *                 cnf,
+         const void *                  src,
+         size_t                        n );
+
+
+extern int
+my_out_delim(
+         my_config_t *                 cnf,
+         int                           delim,
+         unsigned                      level );
+
+
+extern int
+my_out_flush(
+         my_config_t *                 cnf );
+
+
+extern void
+my_out_free(
+         my_config_t *                 cnf );
+
+
+extern int
+my_out_indent(
+         my_config_t *                 cnf,
+         size_t                        width );
+
+
+extern int
+my_out_init(
+         my_config_t *                 cnf );
+
+
+extern int
+my_out_json(
+         my_config_t *                 cnf,
+         const void *                  src,
+         size_t                        n );
+
+
+extern int
+my_out_json_value(
+         my_config_t *                 cnf,
+         const my_value_t *            val );
+
+
+extern int
+my_out_printf(
+         my_config_t *                 cnf,
+         const char *                  fmt,
+         ... );
+
+
+extern int
+my_out_putc(
+         my_config_t *                 cnf,
+         int                           c );
+
+
+extern int
+my_out_puts(
+         my_config_t *                 cnf,
+         const char *                  str );
+
+
+extern int
+my_out_reopen(
+         my_config_t *                 cnf );
+
+
+extern int
+my_out_value(
+         my_config_t *                 cnf,
+         const my_value_t *            val );
+
+
+extern int
+my_out_write(
+         my_config_t *                 cnf,
+         const void *                  ptr,
+         size_t                        len );
+
+
+extern int
+my_out_xml(
+         my_config_t *                 cnf,
+         const void *                  src,
+         size_t                        n );
+
+
+extern int
+my_out_xml_value(
+         my_config_t *                 cnf,
+         const my_value_t *            val );
+
+
 //-------------------//
 // parser prototypes //
 //-------------------//
 #pragma mark parser prototypes
 
+extern const my_emitter_t *
+my_parse_emitter(
+         my_config_t *                 cnf );
+
+
 extern int
 my_parse_footer(
          my_config_t *                 cnf );
 
 
+extern void
+my_parse_free(
+         my_config_t *                 cnf );
+
+
+extern int
+my_parse_intern(
+         my_config_t *                 cnf,
+         const char *                  name );
+
+
+extern int
+my_parse_path_compile(
+         my_path_t *                   path,
+         const char *                  spec );
+
+
+extern void
+my_parse_path_free(
+         my_path_t *                   path );
+
+
+extern char *
+my_parse_path_join(
+         my_config_t *                 cnf,
+         const char *                  key );
+
+
+extern int
+my_parse_path_match(
+         my_config_t *                 cnf,
+         const my_path_t *             path,
+         const char *                  key,
+         int                           prefix );
+
+
 extern int
 my_parse_res(
          const char *                  name,
@@ -271,11 +747,123 @@ my_parse_res(
          int                           is_event );
 
 
+extern int
+my_parse_select(
+         my_config_t *                 cnf );
+
+
+extern int
+my_parse_snapshot(
+         struct davici_response *      res,
+         my_buffer_t *                 tape,
+         my_buffer_t *                 tape_data );
+
+
+extern int
+my_parse_tape(
+         my_config_t *                 cnf,
+         const char *                  name,
+         const my_buffer_t *           tape,
+         const my_buffer_t *           tape_data,
+         int                           is_event );
+
+
+extern int
+my_parse_where(
+         my_config_t *                 cnf,
+         const char *                  expr );
+
+
+//------------------//
+// socks prototypes //
+//------------------//
+#pragma mark socks prototypes
+
+extern int
+my_socks_defer(
+         my_config_t *                 cnf,
+         const char *                  name,
+         struct davici_response *      res,
+         int                           is_event );
+
+
+extern int
+my_socks_exec(
+         my_config_t *                 cnf );
+
+
+extern void
+my_socks_fail(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           err );
+
+
+extern void
+my_socks_free(
+         my_config_t *                 cnf );
+
+
+extern int
+my_socks_open(
+         my_config_t *                 cnf );
+
+
+//------------------//
+// where prototypes //
+//------------------//
+#pragma mark where prototypes
+
+extern int
+my_where_compile(
+         my_where_t *                  where,
+         const char *                  spec );
+
+
+extern int
+my_where_eval(
+         const my_where_t *            where,
+         const char *                  data,
+         size_t                        len );
+
+
+extern void
+my_where_free(
+         my_where_t *                  where );
+
+
+//-------------------//
+// writer prototypes //
+//-------------------//
+#pragma mark writer prototypes
+
+extern int
+my_writer_start(
+         my_config_t *                 cnf );
+
+
+extern int
+my_writer_stop(
+         my_config_t *                 cnf );
+
+
+extern int
+my_writer_writev(
+         my_config_t *                 cnf,
+         struct iovec *                iov,
+         int                           iovcnt );
+
+
 //--------------------//
 // widgets prototypes //
 //--------------------//
 #pragma mark widgets prototypes
 
+extern int
+my_widget_batch(
+         my_config_t *                 cnf );
+
+
 extern int
 my_widget_counters(
          my_config_t *                 cnf );
@@ -285,6 +873,11 @@ extern int
 my_widget_diagnostics(
          my_config_t *                 cnf );
 
+
+extern int
+my_widget_exporter(
+         my_config_t *                 cnf );
+
 extern int
 my_widget_raw(
          my_config_t *                 cnf );
@@ -0,0 +1,1527 @@
+/*
+ *  Davici Utilities for Strongswan
+ *  Copyright (C) 2026 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __SRC_FORMAT_ARROW_C 1
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include "davicictl.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+
+#include <davici.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef   MY_ARROW_BATCH_ROWS
+#define  MY_ARROW_BATCH_ROWS     65536
+
+// scope of column within list-sa event
+#undef   MY_ARROW_IKE
+#define  MY_ARROW_IKE            1
+#undef   MY_ARROW_CHILD
+#define  MY_ARROW_CHILD          2
+
+// column types
+#undef   MY_ARROW_INT64
+#define  MY_ARROW_INT64          1
+#undef   MY_ARROW_UTF8
+#define  MY_ARROW_UTF8           2
+#undef   MY_ARROW_DICT
+#define  MY_ARROW_DICT           3
+#undef   MY_ARROW_UINT64
+#define  MY_ARROW_UINT64         4
+
+// flatbuffer enumerations from Arrow's Message.fbs and Schema.fbs
+#undef   MY_ARROW_METADATA_V5
+#define  MY_ARROW_METADATA_V5    4
+#undef   MY_ARROW_HDR_SCHEMA
+#define  MY_ARROW_HDR_SCHEMA     1
+#undef   MY_ARROW_HDR_DICT
+#define  MY_ARROW_HDR_DICT       2
+#undef   MY_ARROW_HDR_BATCH
+#define  MY_ARROW_HDR_BATCH      3
+#undef   MY_ARROW_TYPE_INT
+#define  MY_ARROW_TYPE_INT       2
+#undef   MY_ARROW_TYPE_UTF8
+#define  MY_ARROW_TYPE_UTF8      5
+
+
+//////////////
+//          //
+//  Macros  //
+//          //
+//////////////
+// MARK: - Macros
+
+#undef   MY_ARROW_PAD8
+#define  MY_ARROW_PAD8(n)        ((8 - ((n) & 7)) & 7)
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+#pragma mark - Datatypes
+
+typedef struct _my_arrow         my_arrow_t;
+typedef struct _my_arrow_body    my_arrow_body_t;
+typedef struct _my_arrow_col     my_arrow_col_t;
+typedef struct _my_arrow_column  my_arrow_column_t;
+typedef struct _my_arrow_fbf     my_arrow_fbf_t;
+
+
+// column definition
+struct _my_arrow_column
+{  const char *                  name;
+   const char *                  key;
+   int                           scope;
+   int                           type;
+};
+
+
+// column data of current record batch
+struct _my_arrow_col
+{  my_buffer_t                   valid;
+   my_buffer_t                   values;
+   my_buffer_t                   data;
+   my_buffer_t                   cur;
+   int                           has_cur;
+   int                           dict_init;
+   int64_t                       nulls;
+   uint32_t                      dict_count;
+   uint32_t                      dict_sent;
+   uint32_t                      dict_hash_size;
+   uint32_t *                    dict_hash;
+   my_buffer_t                   dict_offsets;
+   my_buffer_t                   dict_data;
+};
+
+
+// buffer of IPC message body
+struct _my_arrow_body
+{  const void *                  ptr;
+   size_t                        len;
+};
+
+
+// flatbuffer table field
+struct _my_arrow_fbf
+{  int                           id;
+   int                           size;
+   uint64_t                      value;
+   size_t                        pos;
+};
+
+
+// state of Arrow IPC stream
+struct _my_arrow
+{  int                           ncols;
+   int                           schema_sent;
+   int                           in_children;
+   int                           in_child;
+   int                           list_col;
+   int64_t                       rows;
+   int64_t                       ike_rows;
+   size_t                        body_len;
+   my_buffer_t                   fb;
+   my_buffer_t                   nodes;
+   my_buffer_t                   bufs;
+   my_buffer_t                   body;
+   my_buffer_t                   tmp;
+   my_arrow_col_t                cols[];
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static int
+my_fmt_arrow_append(
+         my_arrow_t *                  arrow,
+         int                           idx );
+
+
+static int
+my_fmt_arrow_batch(
+         my_config_t *                 cnf,
+         my_arrow_t *                  arrow );
+
+
+static int
+my_fmt_arrow_body(
+         my_arrow_t *                  arrow,
+         const void *                  ptr,
+         size_t                        len );
+
+
+static int
+my_fmt_arrow_column(
+         int                           scope,
+         const char *                  key );
+
+
+static int
+my_fmt_arrow_cur(
+         my_arrow_col_t *              col,
+         const my_value_t *            val,
+         int                           sep );
+
+
+static int
+my_fmt_arrow_dict(
+         my_arrow_col_t *              col,
+         const char *                  str,
+         size_t                        len,
+         uint32_t *                    idxp );
+
+
+static int
+my_fmt_arrow_dict_batch(
+         my_config_t *                 cnf,
+         my_arrow_t *                  arrow,
+         int                           idx );
+
+
+static int
+my_fmt_arrow_fb_batch(
+         my_arrow_t *                  arrow,
+         int64_t                       length,
+         size_t                        ref );
+
+
+static int
+my_fmt_arrow_fb_message(
+         my_arrow_t *                  arrow,
+         int                           type,
+         size_t *                      refp );
+
+
+static int
+my_fmt_arrow_fb_pad(
+         my_buffer_t *                 fb,
+         size_t                        align,
+         size_t                        extra );
+
+
+static void
+my_fmt_arrow_fb_patch(
+         my_buffer_t *                 fb,
+         size_t                        pos,
+         size_t                        target );
+
+
+static int
+my_fmt_arrow_fb_string(
+         my_buffer_t *                 fb,
+         const char *                  str,
+         size_t *                      posp );
+
+
+static int
+my_fmt_arrow_fb_table(
+         my_buffer_t *                 fb,
+         my_arrow_fbf_t *              fields,
+         int                           nfields,
+         size_t *                      posp );
+
+
+static int
+my_fmt_arrow_fb_vector(
+         my_buffer_t *                 fb,
+         uint32_t                      count,
+         size_t                        width,
+         const void *                  data,
+         size_t *                      posp );
+
+
+static int
+my_fmt_arrow_footer(
+         my_config_t *                 cnf );
+
+
+static void
+my_fmt_arrow_free(
+         my_arrow_t *                  arrow );
+
+
+static int
+my_fmt_arrow_key_value(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val );
+
+
+static void
+my_fmt_arrow_le(
+         void *                        dst,
+         uint64_t                      val,
+         int                           bytes );
+
+
+static int
+my_fmt_arrow_list_end(
+         my_config_t *                 cnf,
+         unsigned                      level );
+
+
+static int
+my_fmt_arrow_list_item(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const my_value_t *            val );
+
+
+static int
+my_fmt_arrow_list_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key );
+
+
+static int
+my_fmt_arrow_message(
+         my_config_t *                 cnf,
+         my_arrow_t *                  arrow );
+
+
+static int
+my_fmt_arrow_msg_end(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_arrow_msg_start(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_arrow_put(
+         my_buffer_t *                 buff,
+         const void *                  ptr,
+         size_t                        len );
+
+
+static int
+my_fmt_arrow_reset(
+         my_arrow_t *                  arrow,
+         int                           scope );
+
+
+static int
+my_fmt_arrow_row(
+         my_config_t *                 cnf,
+         my_arrow_t *                  arrow );
+
+
+static int
+my_fmt_arrow_schema(
+         my_config_t *                 cnf,
+         my_arrow_t *                  arrow );
+
+
+static int
+my_fmt_arrow_sect_end(
+         my_config_t *                 cnf,
+         unsigned                      level );
+
+
+static int
+my_fmt_arrow_sect_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+// MARK: - Variables
+
+#pragma mark my_arrow_columns[]
+static const my_arrow_column_t my_arrow_columns[] =
+{  // IKE_SA columns
+   { "name",                  NULL,             MY_ARROW_IKE,     MY_ARROW_DICT   },
+   { "uniqueid",              "uniqueid",       MY_ARROW_IKE,     MY_ARROW_INT64  },
+   { "version",               "version",        MY_ARROW_IKE,     MY_ARROW_INT64  },
+   { "state",                 "state",          MY_ARROW_IKE,     MY_ARROW_DICT   },
+   { "local-host",            "local-host",     MY_ARROW_IKE,     MY_ARROW_UTF8   },
+   { "local-port",            "local-port",     MY_ARROW_IKE,     MY_ARROW_INT64  },
+   { "local-id",              "local-id",       MY_ARROW_IKE,     MY_ARROW_UTF8   },
+   { "remote-host",           "remote-host",    MY_ARROW_IKE,     MY_ARROW_UTF8   },
+   { "remote-port",           "remote-port",    MY_ARROW_IKE,     MY_ARROW_INT64  },
+   { "remote-id",             "remote-id",      MY_ARROW_IKE,     MY_ARROW_UTF8   },
+   { "initiator-spi",         "initiator-spi",  MY_ARROW_IKE,     MY_ARROW_UTF8   },
+   { "responder-spi",         "responder-spi",  MY_ARROW_IKE,     MY_ARROW_UTF8   },
+   { "encr-alg",              "encr-alg",       MY_ARROW_IKE,     MY_ARROW_DICT   },
+   { "encr-keysize",          "encr-keysize",   MY_ARROW_IKE,     MY_ARROW_INT64  },
+   { "integ-alg",             "integ-alg",      MY_ARROW_IKE,     MY_ARROW_DICT   },
+   { "prf-alg",               "prf-alg",        MY_ARROW_IKE,     MY_ARROW_DICT   },
+   { "dh-group",              "dh-group",       MY_ARROW_IKE,     MY_ARROW_DICT   },
+   { "established",           "established",    MY_ARROW_IKE,     MY_ARROW_INT64  },
+   { "rekey-time",            "rekey-time",     MY_ARROW_IKE,     MY_ARROW_INT64  },
+   { "reauth-time",           "reauth-time",    MY_ARROW_IKE,     MY_ARROW_INT64  },
+
+   // CHILD_SA columns
+   { "child-name",            "name",           MY_ARROW_CHILD,   MY_ARROW_DICT   },
+   { "child-uniqueid",        "uniqueid",       MY_ARROW_CHILD,   MY_ARROW_INT64  },
+   { "child-reqid",           "reqid",          MY_ARROW_CHILD,   MY_ARROW_INT64  },
+   { "child-state",           "state",          MY_ARROW_CHILD,   MY_ARROW_DICT   },
+   { "child-mode",            "mode",           MY_ARROW_CHILD,   MY_ARROW_DICT   },
+   { "child-protocol",        "protocol",       MY_ARROW_CHILD,   MY_ARROW_DICT   },
+   { "child-spi-in",          "spi-in",         MY_ARROW_CHILD,   MY_ARROW_UTF8   },
+   { "child-spi-out",         "spi-out",        MY_ARROW_CHILD,   MY_ARROW_UTF8   },
+   { "child-encr-alg",        "encr-alg",       MY_ARROW_CHILD,   MY_ARROW_DICT   },
+   { "child-encr-keysize",    "encr-keysize",   MY_ARROW_CHILD,   MY_ARROW_INT64  },
+   { "child-integ-alg",       "integ-alg",      MY_ARROW_CHILD,   MY_ARROW_DICT   },
+   { "child-dh-group",        "dh-group",       MY_ARROW_CHILD,   MY_ARROW_DICT   },
+   { "bytes-in",              "bytes-in",       MY_ARROW_CHILD,   MY_ARROW_UINT64 },
+   { "packets-in",            "packets-in",     MY_ARROW_CHILD,   MY_ARROW_UINT64 },
+   { "bytes-out",             "bytes-out",      MY_ARROW_CHILD,   MY_ARROW_UINT64 },
+   { "packets-out",           "packets-out",    MY_ARROW_CHILD,   MY_ARROW_UINT64 },
+   { "child-rekey-time",      "rekey-time",     MY_ARROW_CHILD,   MY_ARROW_INT64  },
+   { "child-life-time",       "life-time",      MY_ARROW_CHILD,   MY_ARROW_INT64  },
+   { "child-install-time",    "install-time",   MY_ARROW_CHILD,   MY_ARROW_INT64  },
+   { "local-ts",              "local-ts",       MY_ARROW_CHILD,   MY_ARROW_UTF8   },
+   { "remote-ts",             "remote-ts",      MY_ARROW_CHILD,   MY_ARROW_UTF8   },
+
+   // path of vici socket, last column is only present with multiple sockets
+   { "socket",                "socket",         MY_ARROW_IKE,     MY_ARROW_DICT   },
+   { NULL,                    NULL,             0,                0               }
+};
+
+#pragma mark my_arrow_ncols
+static const int my_arrow_ncols = (int)(sizeof(my_arrow_columns) / sizeof(my_arrow_columns[0])) - 1;
+
+#pragma mark my_emitter_arrow
+const my_emitter_t my_emitter_arrow =
+{  .format           = MY_FMT_ARROW,
+   .flags            = MY_EMIT_ROWS,
+   .func_footer      = &my_fmt_arrow_footer,
+   .func_key_value   = &my_fmt_arrow_key_value,
+   .func_list_end    = &my_fmt_arrow_list_end,
+   .func_list_item   = &my_fmt_arrow_list_item,
+   .func_list_start  = &my_fmt_arrow_list_start,
+   .func_msg_end     = &my_fmt_arrow_msg_end,
+   .func_msg_start   = &my_fmt_arrow_msg_start,
+   .func_sect_end    = &my_fmt_arrow_sect_end,
+   .func_sect_start  = &my_fmt_arrow_sect_start,
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+my_fmt_arrow_append(
+         my_arrow_t *                  arrow,
+         int                           idx )
+{
+   int               rc;
+   int               is_null;
+   char *            end;
+   uint8_t *         ptr;
+   uint32_t          dict_idx;
+   uint64_t          num;
+   my_arrow_col_t *  col;
+
+   col      = &arrow->cols[idx];
+   is_null  = ((col->has_cur)) ? 0 : 1;
+   num      = 0;
+   dict_idx = 0;
+
+   // convert current value of column
+   if (!(is_null))
+   {  switch(my_arrow_columns[idx].type)
+      {  case MY_ARROW_INT64:
+            if ((rc = my_fmt_arrow_put(&col->cur, "", 1)) < 0)
+               return(rc);
+            col->cur.len--;
+            errno = 0;
+            num   = (uint64_t)strtoll(col->cur.data, &end, 10);
+            if ( (!(col->cur.len)) || (*end != '\0') || (errno == ERANGE) )
+            {  is_null  = 1;
+               num      = 0;
+            };
+            break;
+
+         // byte and packet counters are unsigned 64-bit values
+         case MY_ARROW_UINT64:
+            if ((rc = my_fmt_arrow_put(&col->cur, "", 1)) < 0)
+               return(rc);
+            col->cur.len--;
+            errno = 0;
+            num   = (uint64_t)strtoumax(col->cur.data, &end, 10);
+            if ( (!(col->cur.len)) || (col->cur.data[0] == '-') || (*end != '\0') || (errno == ERANGE) )
+            {  is_null  = 1;
+               num      = 0;
+            };
+            break;
+
+         case MY_ARROW_UTF8:
+            if ((rc = my_fmt_arrow_put(&col->data, col->cur.data, col->cur.len)) < 0)
+               return(rc);
+            break;
+
+         default:
+            if ((rc = my_fmt_arrow_dict(col, col->cur.data, col->cur.len, &dict_idx)) < 0)
+               return(rc);
+            break;
+      };
+   };
+
+   // append validity bit
+   if (!(arrow->rows & 7))
+   {  if ((ptr = my_buffer_alloc(&col->valid, 1)) == NULL)
+         return(-ENOMEM);
+      *ptr = 0;
+   };
+   if (!(is_null))
+      col->valid.data[arrow->rows >> 3] |= (char)(1 << (arrow->rows & 7));
+   else
+      col->nulls++;
+
+   // append value, string offset, or dictionary index
+   if ( (my_arrow_columns[idx].type == MY_ARROW_INT64) || (my_arrow_columns[idx].type == MY_ARROW_UINT64) )
+   {  if ((ptr = my_buffer_alloc(&col->values, 8)) == NULL)
+         return(-ENOMEM);
+      my_fmt_arrow_le(ptr, num, 8);
+      return(0);
+   };
+   if ((ptr = my_buffer_alloc(&col->values, 4)) == NULL)
+      return(-ENOMEM);
+   if (my_arrow_columns[idx].type == MY_ARROW_UTF8)
+      my_fmt_arrow_le(ptr, (uint64_t)col->data.len, 4);
+   else
+      my_fmt_arrow_le(ptr, (uint64_t)dict_idx, 4);
+
+   return(0);
+}
+
+
+int
+my_fmt_arrow_batch(
+         my_config_t *                 cnf,
+         my_arrow_t *                  arrow )
+{
+   int               rc;
+   int               idx;
+   size_t            hdr;
+   uint8_t *         ptr;
+   my_arrow_col_t *  col;
+
+   if (!(arrow->rows))
+      return(0);
+
+   if (!(arrow->schema_sent))
+      if ((rc = my_fmt_arrow_schema(cnf, arrow)) < 0)
+         return(rc);
+
+   // dictionaries must precede the first record batch which references them
+   for(idx = 0; (idx < arrow->ncols); idx++)
+   {  col = &arrow->cols[idx];
+      if (my_arrow_columns[idx].type != MY_ARROW_DICT)
+         continue;
+      if ( ((col->dict_init)) && (col->dict_count == col->dict_sent) )
+         continue;
+      if ((rc = my_fmt_arrow_dict_batch(cnf, arrow, idx)) < 0)
+         return(rc);
+   };
+
+   // describe field node and buffers of each column
+   arrow->nodes.len  = 0;
+   arrow->bufs.len   = 0;
+   arrow->body.len   = 0;
+   arrow->body_len   = 0;
+   for(idx = 0; (idx < arrow->ncols); idx++)
+   {  col = &arrow->cols[idx];
+      if ((ptr = my_buffer_alloc(&arrow->nodes, 16)) == NULL)
+         return(-ENOMEM);
+      my_fmt_arrow_le(&ptr[0], (uint64_t)arrow->rows,  8);
+      my_fmt_arrow_le(&ptr[8], (uint64_t)col->nulls,   8);
+      if ((rc = my_fmt_arrow_body(arrow, col->valid.data, ((col->nulls)) ? col->valid.len : 0)) < 0)
+         return(rc);
+      if ((rc = my_fmt_arrow_body(arrow, col->values.data, col->values.len)) < 0)
+         return(rc);
+      if (my_arrow_columns[idx].type == MY_ARROW_UTF8)
+         if ((rc = my_fmt_arrow_body(arrow, col->data.data, col->data.len)) < 0)
+            return(rc);
+   };
+
+   if ((rc = my_fmt_arrow_fb_message(arrow, MY_ARROW_HDR_BATCH, &hdr)) < 0)
+      return(rc);
+   if ((rc = my_fmt_arrow_fb_batch(arrow, arrow->rows, hdr)) < 0)
+      return(rc);
+   if ((rc = my_fmt_arrow_message(cnf, arrow)) < 0)
+      return(rc);
+
+   // start next record batch
+   arrow->rows = 0;
+   my_fmt_arrow_reset(arrow, 0);
+
+   return(0);
+}
+
+
+int
+my_fmt_arrow_body(
+         my_arrow_t *                  arrow,
+         const void *                  ptr,
+         size_t                        len )
+{
+   uint8_t *            buff;
+   my_arrow_body_t      part;
+
+   // Buffer struct: offset and length within message body
+   if ((buff = my_buffer_alloc(&arrow->bufs, 16)) == NULL)
+      return(-ENOMEM);
+   my_fmt_arrow_le(&buff[0], (uint64_t)arrow->body_len, 8);
+   my_fmt_arrow_le(&buff[8], (uint64_t)len,             8);
+
+   part.ptr          = ptr;
+   part.len          = len;
+   arrow->body_len  += len + MY_ARROW_PAD8(len);
+
+   return(my_fmt_arrow_put(&arrow->body, &part, sizeof(part)));
+}
+
+
+int
+my_fmt_arrow_column(
+         int                           scope,
+         const char *                  key )
+{
+   int               idx;
+
+   for(idx = 0; (idx < my_arrow_ncols); idx++)
+   {  if (my_arrow_columns[idx].scope != scope)
+         continue;
+      if (!(my_arrow_columns[idx].key))
+         continue;
+      if (!(strcmp(my_arrow_columns[idx].key, key)))
+         return(idx);
+   };
+
+   return(-1);
+}
+
+
+int
+my_fmt_arrow_cur(
+         my_arrow_col_t *              col,
+         const my_value_t *            val,
+         int                           sep )
+{
+   int               rc;
+   char *            ptr;
+   size_t            len;
+
+   // list items are joined into a single comma separated value
+   if ( ((sep)) && ((col->has_cur)) )
+   {  if ((rc = my_fmt_arrow_put(&col->cur, ",", 1)) < 0)
+         return(rc);
+   }
+   else
+   {  col->cur.len = 0;
+   };
+   col->has_cur = 1;
+
+   if (!(val->is_binary))
+      return(my_fmt_arrow_put(&col->cur, val->data, val->len));
+
+   // binary values are stored as base64 within utf8 columns
+   len = MY_BASE64_LEN(val->len) + 1;
+   if ((ptr = my_buffer_alloc(&col->cur, len)) == NULL)
+      return(-ENOMEM);
+   col->cur.len -= len;
+   if ((rc = my_base64_encode(ptr, len, (const uint8_t *)val->data, val->len)) < 0)
+      return(rc);
+   col->cur.len += (size_t)rc;
+
+   return(0);
+}
+
+
+int
+my_fmt_arrow_dict(
+         my_arrow_col_t *              col,
+         const char *                  str,
+         size_t                        len,
+         uint32_t *                    idxp )
+{
+   uint32_t          hash;
+   uint32_t          mask;
+   uint32_t          slot;
+   uint32_t          size;
+   uint32_t          entry;
+   uint32_t *        table;
+   uint32_t *        offs;
+   uint32_t          off;
+   size_t            pos;
+
+   // grow open addressing table to keep load factor below one half
+   if (((col->dict_count + 1) * 2) > col->dict_hash_size)
+   {  size = ((col->dict_hash_size)) ? (col->dict_hash_size * 2) : 64;
+      if ((table = calloc(size, sizeof(uint32_t))) == NULL)
+         return(-ENOMEM);
+      offs = (uint32_t *)col->dict_offsets.data;
+      for(entry = 0; (entry < col->dict_count); entry++)
+      {  hash = 2166136261U;
+         for(pos = offs[entry]; (pos < offs[entry+1]); pos++)
+            hash = (hash ^ (uint8_t)col->dict_data.data[pos]) * 16777619U;
+         for(slot = hash & (size - 1); ((table[slot])); slot = (slot + 1) & (size - 1));
+         table[slot] = entry + 1;
+      };
+      free(col->dict_hash);
+      col->dict_hash       = table;
+      col->dict_hash_size  = size;
+   };
+
+   // FNV-1a hash of value
+   hash = 2166136261U;
+   for(pos = 0; (pos < len); pos++)
+      hash = (hash ^ (uint8_t)str[pos]) * 16777619U;
+
+   // search for existing entry
+   mask = col->dict_hash_size - 1;
+   offs = (uint32_t *)col->dict_offsets.data;
+   for(slot = hash & mask; ((col->dict_hash[slot])); slot = (slot + 1) & mask)
+   {  entry = col->dict_hash[slot] - 1;
+      if ((offs[entry+1] - offs[entry]) != len)
+         continue;
+      if (!(memcmp(&col->dict_data.data[offs[entry]], str, len)))
+      {  *idxp = entry;
+         return(0);
+      };
+   };
+
+   // add new entry
+   if (!(col->dict_offsets.len))
+   {  off = 0;
+      if (my_fmt_arrow_put(&col->dict_offsets, &off, sizeof(off)) < 0)
+         return(-ENOMEM);
+   };
+   if (my_fmt_arrow_put(&col->dict_data, str, len) < 0)
+      return(-ENOMEM);
+   off = (uint32_t)col->dict_data.len;
+   if (my_fmt_arrow_put(&col->dict_offsets, &off, sizeof(off)) < 0)
+      return(-ENOMEM);
+   col->dict_hash[slot] = col->dict_count + 1;
+   *idxp = col->dict_count++;
+
+   return(0);
+}
+
+
+int
+my_fmt_arrow_dict_batch(
+         my_config_t *                 cnf,
+         my_arrow_t *                  arrow,
+         int                           idx )
+{
+   int               rc;
+   size_t            hdr;
+   size_t            pos;
+   uint8_t *         ptr;
+   uint32_t          entry;
+   uint32_t          base;
+   uint32_t          count;
+   uint32_t *        offs;
+   my_arrow_col_t *  col;
+   my_arrow_fbf_t    dict[] =
+   {  { 0, 8, 0, 0 },                  // id
+      { 1, 4, 0, 0 },                  // data
+      { 2, 1, 0, 0 },                  // isDelta
+   };
+
+   col   = &arrow->cols[idx];
+   offs  = (uint32_t *)col->dict_offsets.data;
+   count = col->dict_count - col->dict_sent;
+   base  = ((col->dict_count)) ? offs[col->dict_sent] : 0;
+
+   // rebase offsets of entries added since previous dictionary batch
+   arrow->tmp.len = 0;
+   if ((ptr = (uint8_t *)my_buffer_alloc(&arrow->tmp, (count + 1) * 4)) == NULL)
+      return(-ENOMEM);
+   for(entry = 0; (entry <= count); entry++)
+      my_fmt_arrow_le(&ptr[entry*4], (uint64_t)(((col->dict_count)) ? (offs[col->dict_sent+entry] - base) : 0), 4);
+
+   arrow->nodes.len  = 0;
+   arrow->bufs.len   = 0;
+   arrow->body.len   = 0;
+   arrow->body_len   = 0;
+   if ((ptr = my_buffer_alloc(&arrow->nodes, 16)) == NULL)
+      return(-ENOMEM);
+   my_fmt_arrow_le(&ptr[0], (uint64_t)count, 8);
+   my_fmt_arrow_le(&ptr[8], 0,               8);
+   if ((rc = my_fmt_arrow_body(arrow, NULL, 0)) < 0)
+      return(rc);
+   if ((rc = my_fmt_arrow_body(arrow, arrow->tmp.data, arrow->tmp.len)) < 0)
+      return(rc);
+   if ((rc = my_fmt_arrow_body(arrow, ((col->dict_count)) ? &col->dict_data.data[base] : NULL, ((col->dict_count)) ? (offs[col->dict_count] - base) : 0)) < 0)
+      return(rc);
+
+   // build DictionaryBatch message
+   if ((rc = my_fmt_arrow_fb_message(arrow, MY_ARROW_HDR_DICT, &hdr)) < 0)
+      return(rc);
+   dict[0].value = (uint64_t)idx;
+   dict[2].value = (uint64_t)col->dict_init;
+   if ((rc = my_fmt_arrow_fb_table(&arrow->fb, dict, 3, &pos)) < 0)
+      return(rc);
+   my_fmt_arrow_fb_patch(&arrow->fb, hdr, pos);
+   if ((rc = my_fmt_arrow_fb_batch(arrow, (int64_t)count, dict[1].pos)) < 0)
+      return(rc);
+   if ((rc = my_fmt_arrow_message(cnf, arrow)) < 0)
+      return(rc);
+
+   col->dict_init = 1;
+   col->dict_sent = col->dict_count;
+
+   return(0);
+}
+
+
+int
+my_fmt_arrow_fb_batch(
+         my_arrow_t *                  arrow,
+         int64_t                       length,
+         size_t                        ref )
+{
+   int               rc;
+   size_t            pos;
+   size_t            vec;
+   my_arrow_fbf_t    batch[] =
+   {  { 0, 8, 0, 0 },                  // length
+      { 1, 4, 0, 0 },                  // nodes
+      { 2, 4, 0, 0 },                  // buffers
+   };
+
+   batch[0].value = (uint64_t)length;
+   if ((rc = my_fmt_arrow_fb_table(&arrow->fb, batch, 3, &pos)) < 0)
+      return(rc);
+   my_fmt_arrow_fb_patch(&arrow->fb, ref, pos);
+
+   if ((rc = my_fmt_arrow_fb_vector(&arrow->fb, (uint32_t)(arrow->nodes.len / 16), 16, arrow->nodes.data, &vec)) < 0)
+      return(rc);
+   my_fmt_arrow_fb_patch(&arrow->fb, batch[1].pos, vec);
+
+   if ((rc = my_fmt_arrow_fb_vector(&arrow->fb, (uint32_t)(arrow->bufs.len / 16), 16, arrow->bufs.data, &vec)) < 0)
+      return(rc);
+   my_fmt_arrow_fb_patch(&arrow->fb, batch[2].pos, vec);
+
+   return(0);
+}
+
+
+int
+my_fmt_arrow_fb_message(
+         my_arrow_t *                  arrow,
+         int                           type,
+         size_t *                      refp )
+{
+   int               rc;
+   size_t            pos;
+   uint8_t *         ptr;
+   my_arrow_fbf_t    msg[] =
+   {  { 0, 2, MY_ARROW_METADATA_V5, 0 },  // version
+      { 1, 1, 0, 0 },                     // header_type
+      { 2, 4, 0, 0 },                     // header
+      { 3, 8, 0, 0 },                     // bodyLength
+   };
+
+   // flatbuffer starts with offset of root table
+   arrow->fb.len = 0;
+   if ((ptr = my_buffer_alloc(&arrow->fb, 4)) == NULL)
+      return(-ENOMEM);
+
+   msg[1].value = (uint64_t)type;
+   msg[3].value = (uint64_t)arrow->body_len;
+   if ((rc = my_fmt_arrow_fb_table(&arrow->fb, msg, 4, &pos)) < 0)
+      return(rc);
+   my_fmt_arrow_fb_patch(&arrow->fb, 0, pos);
+   *refp = msg[2].pos;
+
+   return(0);
+}
+
+
+int
+my_fmt_arrow_fb_pad(
+         my_buffer_t *                 fb,
+         size_t                        align,
+         size_t                        extra )
+{
+   size_t            len;
+   char *            ptr;
+
+   len = (align - ((fb->len + extra) % align)) % align;
+   if (!(len))
+      return(0);
+   if ((ptr = my_buffer_alloc(fb, len)) == NULL)
+      return(-ENOMEM);
+   memset(ptr, 0, len);
+
+   return(0);
+}
+
+
+void
+my_fmt_arrow_fb_patch(
+         my_buffer_t *                 fb,
+         size_t                        pos,
+         size_t                        target )
+{
+   // flatbuffer offsets are relative to the location of the offset
+   my_fmt_arrow_le(&fb->data[pos], (uint64_t)(target - pos), 4);
+   return;
+}
+
+
+int
+my_fmt_arrow_fb_string(
+         my_buffer_t *                 fb,
+         const char *                  str,
+         size_t *                      posp )
+{
+   int               rc;
+   size_t            len;
+   char *            ptr;
+
+   len = strlen(str);
+   if ((rc = my_fmt_arrow_fb_pad(fb, 4, 0)) < 0)
+      return(rc);
+   *posp = fb->len;
+   if ((ptr = my_buffer_alloc(fb, len + 5)) == NULL)
+      return(-ENOMEM);
+   my_fmt_arrow_le(ptr, (uint64_t)len, 4);
+   memcpy(&ptr[4], str, len + 1);
+
+   return(0);
+}
+
+
+int
+my_fmt_arrow_fb_table(
+         my_buffer_t *                 fb,
+         my_arrow_fbf_t *              fields,
+         int                           nfields,
+         size_t *                      posp )
+{
+   int               rc;
+   int               idx;
+   int               size;
+   int               nslots;
+   size_t            vt;
+   size_t            tbl;
+   size_t            off;
+   char *            ptr;
+
+   // vtable holds one slot per field id up to the highest id present
+   nslots = 0;
+   for(idx = 0; (idx < nfields); idx++)
+      if ( ((fields[idx].size)) && (fields[idx].id >= nslots) )
+         nslots = fields[idx].id + 1;
+
+   if ((rc = my_fmt_arrow_fb_pad(fb, 2, 0)) < 0)
+      return(rc);
+   vt = fb->len;
+   if ((ptr = my_buffer_alloc(fb, (size_t)(4 + (nslots * 2)))) == NULL)
+      return(-ENOMEM);
+   memset(ptr, 0, (size_t)(4 + (nslots * 2)));
+
+   // table follows vtable, fields are placed largest first to keep alignment
+   if ((rc = my_fmt_arrow_fb_pad(fb, 8, 0)) < 0)
+      return(rc);
+   tbl = fb->len;
+   off = 4;
+   for(size = 8; (size > 0); size /= 2)
+   {  for(idx = 0; (idx < nfields); idx++)
+      {  if (fields[idx].size != size)
+            continue;
+         off               = (off + (size_t)size - 1) & ~((size_t)size - 1);
+         fields[idx].pos   = tbl + off;
+         off              += (size_t)size;
+      };
+   };
+   off = (off + 3) & ~((size_t)3);
+   if ((ptr = my_buffer_alloc(fb, off)) == NULL)
+      return(-ENOMEM);
+   memset(ptr, 0, off);
+
+   // soffset from table to vtable, vtable size, table size, field offsets
+   my_fmt_arrow_le(&fb->data[tbl],    (uint64_t)(tbl - vt),          4);
+   my_fmt_arrow_le(&fb->data[vt + 0], (uint64_t)(4 + (nslots * 2)),  2);
+   my_fmt_arrow_le(&fb->data[vt + 2], (uint64_t)off,                 2);
+   for(idx = 0; (idx < nfields); idx++)
+   {  if (!(fields[idx].size))
+         continue;
+      my_fmt_arrow_le(&fb->data[vt + 4 + (size_t)(fields[idx].id * 2)], (uint64_t)(fields[idx].pos - tbl), 2);
+      my_fmt_arrow_le(&fb->data[fields[idx].pos], fields[idx].value, fields[idx].size);
+   };
+
+   *posp = tbl;
+
+   return(0);
+}
+
+
+int
+my_fmt_arrow_fb_vector(
+         my_buffer_t *                 fb,
+         uint32_t                      count,
+         size_t                        width,
+         const void *                  data,
+         size_t *                      posp )
+{
+   int               rc;
+   char *            ptr;
+
+   // elements of struct vectors must be aligned to 8 bytes
+   if ((rc = my_fmt_arrow_fb_pad(fb, 8, 4)) < 0)
+      return(rc);
+   *posp = fb->len;
+   if ((ptr = my_buffer_alloc(fb, 4 + (count * width))) == NULL)
+      return(-ENOMEM);
+   my_fmt_arrow_le(ptr, (uint64_t)count, 4);
+   if ((data))
+      memcpy(&ptr[4], data, count * width);
+   else
+      memset(&ptr[4], 0, count * width);
+
+   return(0);
+}
+
+
+int
+my_fmt_arrow_footer(
+         my_config_t *                 cnf )
+{
+   int               rc;
+   my_arrow_t *      arrow;
+
+   // flush remaining rows and end stream, a schema is written even if no
+   // SAs were returned so that readers receive an empty table
+   if (!(cnf->emitter_state))
+      if ((rc = my_fmt_arrow_msg_start(cnf, "list-sas", 0)) < 0)
+         return(rc);
+   if ((arrow = cnf->emitter_state) == NULL)
+      return(0);
+
+   if ((rc = my_fmt_arrow_batch(cnf, arrow)) == 0)
+      if ((rc = (arrow->schema_sent) ? 0 : my_fmt_arrow_schema(cnf, arrow)) == 0)
+         rc = my_out_write(cnf, "\377\377\377\377\0\0\0\0", 8);
+
+   my_fmt_arrow_free(arrow);
+   cnf->emitter_state = NULL;
+
+   return(rc);
+}
+
+
+void
+my_fmt_arrow_free(
+         my_arrow_t *                  arrow )
+{
+   int               idx;
+   my_arrow_col_t *  col;
+
+   if (!(arrow))
+      return;
+
+   for(idx = 0; (idx < my_arrow_ncols); idx++)
+   {  col = &arrow->cols[idx];
+      my_buffer_free(&col->valid);
+      my_buffer_free(&col->values);
+      my_buffer_free(&col->data);
+      my_buffer_free(&col->cur);
+      my_buffer_free(&col->dict_offsets);
+      my_buffer_free(&col->dict_data);
+      free(col->dict_hash);
+   };
+   my_buffer_free(&arrow->fb);
+   my_buffer_free(&arrow->nodes);
+   my_buffer_free(&arrow->bufs);
+   my_buffer_free(&arrow->body);
+   my_buffer_free(&arrow->tmp);
+   free(arrow);
+
+   return;
+}
+
+
+int
+my_fmt_arrow_key_value(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val )
+{
+   int               idx;
+   my_arrow_t *      arrow;
+
+   arrow = cnf->emitter_state;
+
+   if (level == 2)
+      idx = my_fmt_arrow_column(MY_ARROW_IKE, key);
+   else if ( (level == 4) && ((arrow->in_child)) )
+      idx = my_fmt_arrow_column(MY_ARROW_CHILD, key);
+   else
+      idx = -1;
+   if (idx < 0)
+      return(0);
+
+   return(my_fmt_arrow_cur(&arrow->cols[idx], val, 0));
+}
+
+
+void
+my_fmt_arrow_le(
+         void *                        dst,
+         uint64_t                      val,
+         int                           bytes )
+{
+   int               pos;
+   uint8_t *         ptr;
+
+   ptr = dst;
+   for(pos = 0; (pos < bytes); pos++)
+      ptr[pos] = (uint8_t)((val >> (pos * 8)) & 0xff);
+
+   return;
+}
+
+
+int
+my_fmt_arrow_list_end(
+         my_config_t *                 cnf,
+         unsigned                      level )
+{
+   my_arrow_t *      arrow;
+
+   (void)level;
+
+   arrow             = cnf->emitter_state;
+   arrow->list_col   = -1;
+
+   return(0);
+}
+
+
+int
+my_fmt_arrow_list_item(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const my_value_t *            val )
+{
+   my_arrow_t *      arrow;
+
+   (void)level;
+
+   arrow = cnf->emitter_state;
+   if (arrow->list_col < 0)
+      return(0);
+
+   return(my_fmt_arrow_cur(&arrow->cols[arrow->list_col], val, 1));
+}
+
+
+int
+my_fmt_arrow_list_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key )
+{
+   my_arrow_t *      arrow;
+
+   arrow = cnf->emitter_state;
+
+   if (level == 2)
+      arrow->list_col = my_fmt_arrow_column(MY_ARROW_IKE, key);
+   else if ( (level == 4) && ((arrow->in_child)) )
+      arrow->list_col = my_fmt_arrow_column(MY_ARROW_CHILD, key);
+   else
+      arrow->list_col = -1;
+   if (arrow->list_col >= 0)
+      arrow->cols[arrow->list_col].has_cur = 0;
+
+   return(0);
+}
+
+
+int
+my_fmt_arrow_message(
+         my_config_t *                 cnf,
+         my_arrow_t *                  arrow )
+{
+   int               rc;
+   size_t            pos;
+   uint8_t           prefix[8];
+   my_arrow_body_t * part;
+
+   // encapsulated message: continuation marker, metadata length,
+   // flatbuffer padded to 8 bytes, then message body
+   if ((rc = my_fmt_arrow_fb_pad(&arrow->fb, 8, 0)) < 0)
+      return(rc);
+   my_fmt_arrow_le(&prefix[0], 0xffffffff,              4);
+   my_fmt_arrow_le(&prefix[4], (uint64_t)arrow->fb.len, 4);
+   if ((rc = my_out_write(cnf, prefix, sizeof(prefix))) < 0)
+      return(rc);
+   if ((rc = my_out_write(cnf, arrow->fb.data, arrow->fb.len)) < 0)
+      return(rc);
+
+   for(pos = 0; (pos < arrow->body.len); pos += sizeof(my_arrow_body_t))
+   {  part = (my_arrow_body_t *)&arrow->body.data[pos];
+      if (!(part->len))
+         continue;
+      if ((rc = my_out_write(cnf, part->ptr, part->len)) < 0)
+         return(rc);
+      if ((MY_ARROW_PAD8(part->len)))
+         if ((rc = my_out_write(cnf, "\0\0\0\0\0\0\0", MY_ARROW_PAD8(part->len))) < 0)
+            return(rc);
+   };
+
+   return(0);
+}
+
+
+int
+my_fmt_arrow_msg_end(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  name,
+         int                           is_event )
+{
+   (void)level;
+   (void)name;
+
+   // list-sas reply marks the end of a snapshot
+   if ((is_event))
+      return(0);
+
+   return(my_fmt_arrow_batch(cnf, cnf->emitter_state));
+}
+
+
+int
+my_fmt_arrow_msg_start(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event )
+{
+   my_arrow_t *      arrow;
+
+   if (strcasecmp(name, ((is_event)) ? "list-sa" : "list-sas"))
+   {  fprintf(stderr, "%s: arrow output is only supported by list-sas\n", my_prog_name(cnf));
+      return(-ENOTSUP);
+   };
+
+   if ((arrow = cnf->emitter_state) == NULL)
+   {  if ((arrow = calloc(1, sizeof(my_arrow_t) + ((size_t)my_arrow_ncols * sizeof(my_arrow_col_t)))) == NULL)
+         return(-ENOMEM);
+      cnf->emitter_state = arrow;
+      arrow->ncols       = ((cnf->sock)) ? my_arrow_ncols : (my_arrow_ncols - 1);
+      if (my_fmt_arrow_reset(arrow, 0) < 0)
+         return(-ENOMEM);
+   };
+
+   arrow->in_children   = 0;
+   arrow->in_child      = 0;
+   arrow->list_col      = -1;
+
+   return(0);
+}
+
+
+int
+my_fmt_arrow_put(
+         my_buffer_t *                 buff,
+         const void *                  ptr,
+         size_t                        len )
+{
+   char *            dst;
+
+   if (!(len))
+      return(0);
+   if ((dst = my_buffer_alloc(buff, len)) == NULL)
+      return(-ENOMEM);
+   memcpy(dst, ptr, len);
+
+   return(0);
+}
+
+
+int
+my_fmt_arrow_reset(
+         my_arrow_t *                  arrow,
+         int                           scope )
+{
+   int               rc;
+   int               idx;
+   my_arrow_col_t *  col;
+
+   for(idx = 0; (idx < arrow->ncols); idx++)
+   {  col = &arrow->cols[idx];
+
+      // clear current values of IKE_SA or CHILD_SA columns
+      if ((scope))
+      {  if (my_arrow_columns[idx].scope == scope)
+            col->has_cur = 0;
+         continue;
+      };
+
+      // clear column data of record batch
+      col->valid.len    = 0;
+      col->values.len   = 0;
+      col->data.len     = 0;
+      col->nulls        = 0;
+      if (my_arrow_columns[idx].type == MY_ARROW_UTF8)
+         if ((rc = my_fmt_arrow_put(&col->values, "\0\0\0\0", 4)) < 0)
+            return(rc);
+   };
+
+   return(0);
+}
+
+
+int
+my_fmt_arrow_row(
+         my_config_t *                 cnf,
+         my_arrow_t *                  arrow )
+{
+   int               rc;
+   int               idx;
+
+   for(idx = 0; (idx < arrow->ncols); idx++)
+      if ((rc = my_fmt_arrow_append(arrow, idx)) < 0)
+         return(rc);
+   arrow->rows++;
+
+   if (arrow->rows < MY_ARROW_BATCH_ROWS)
+      return(0);
+
+   return(my_fmt_arrow_batch(cnf, arrow));
+}
+
+
+int
+my_fmt_arrow_schema(
+         my_config_t *                 cnf,
+         my_arrow_t *                  arrow )
+{
+   int               rc;
+   int               idx;
+   int               is_int;
+   size_t            hdr;
+   size_t            pos;
+   size_t            vec;
+   my_buffer_t *     fb;
+   my_arrow_fbf_t    schema[] =
+   {  { 0, 2, 0, 0 },                  // endianness: Little
+      { 1, 4, 0, 0 },                  // fields
+   };
+   my_arrow_fbf_t    field[] =
+   {  { 0, 4, 0, 0 },                  // name
+      { 1, 1, 1, 0 },                  // nullable
+      { 2, 1, 0, 0 },                  // type_type
+      { 3, 4, 0, 0 },                  // type
+      { 4, 4, 0, 0 },                  // dictionary
+      { 5, 4, 0, 0 },                  // children
+   };
+   my_arrow_fbf_t    integer[] =
+   {  { 0, 4, 0, 0 },                  // bitWidth
+      { 1, 1, 1, 0 },                  // is_signed
+   };
+   my_arrow_fbf_t    encoding[] =
+   {  { 0, 8, 0, 0 },                  // id
+      { 1, 4, 0, 0 },                  // indexType
+   };
+
+   fb             = &arrow->fb;
+   arrow->body.len = 0;
+   arrow->body_len = 0;
+
+   if ((rc = my_fmt_arrow_fb_message(arrow, MY_ARROW_HDR_SCHEMA, &hdr)) < 0)
+      return(rc);
+   if ((rc = my_fmt_arrow_fb_table(fb, schema, 2, &pos)) < 0)
+      return(rc);
+   my_fmt_arrow_fb_patch(fb, hdr, pos);
+   if ((rc = my_fmt_arrow_fb_vector(fb, (uint32_t)arrow->ncols, 4, NULL, &vec)) < 0)
+      return(rc);
+   my_fmt_arrow_fb_patch(fb, schema[1].pos, vec);
+
+   for(idx = 0; (idx < arrow->ncols); idx++)
+   {  // Field table
+      is_int         = ( (my_arrow_columns[idx].type == MY_ARROW_INT64) || (my_arrow_columns[idx].type == MY_ARROW_UINT64) ) ? 1 : 0;
+      field[2].value = ((is_int)) ? MY_ARROW_TYPE_INT : MY_ARROW_TYPE_UTF8;
+      field[4].size  = (my_arrow_columns[idx].type == MY_ARROW_DICT)  ? 4 : 0;
+      if ((rc = my_fmt_arrow_fb_table(fb, field, 6, &pos)) < 0)
+         return(rc);
+      my_fmt_arrow_fb_patch(fb, vec + 4 + ((size_t)idx * 4), pos);
+
+      if ((rc = my_fmt_arrow_fb_string(fb, my_arrow_columns[idx].name, &pos)) < 0)
+         return(rc);
+      my_fmt_arrow_fb_patch(fb, field[0].pos, pos);
+
+      // Int or Utf8 type table
+      integer[0].value = 64;
+      integer[1].value = (my_arrow_columns[idx].type == MY_ARROW_UINT64) ? 0 : 1;
+      if ((rc = my_fmt_arrow_fb_table(fb, integer, ((is_int)) ? 2 : 0, &pos)) < 0)
+         return(rc);
+      my_fmt_arrow_fb_patch(fb, field[3].pos, pos);
+
+      // DictionaryEncoding with int32 indices
+      if (my_arrow_columns[idx].type == MY_ARROW_DICT)
+      {  encoding[0].value = (uint64_t)idx;
+         if ((rc = my_fmt_arrow_fb_table(fb, encoding, 2, &pos)) < 0)
+            return(rc);
+         my_fmt_arrow_fb_patch(fb, field[4].pos, pos);
+         integer[0].value = 32;
+         integer[1].value = 1;
+         if ((rc = my_fmt_arrow_fb_table(fb, integer, 2, &pos)) < 0)
+            return(rc);
+         my_fmt_arrow_fb_patch(fb, encoding[1].pos, pos);
+      };
+
+      if ((rc = my_fmt_arrow_fb_vector(fb, 0, 4, NULL, &pos)) < 0)
+         return(rc);
+      my_fmt_arrow_fb_patch(fb, field[5].pos, pos);
+   };
+
+   if ((rc = my_fmt_arrow_message(cnf, arrow)) < 0)
+      return(rc);
+   arrow->schema_sent = 1;
+
+   return(0);
+}
+
+
+int
+my_fmt_arrow_sect_end(
+         my_config_t *                 cnf,
+         unsigned                      level )
+{
+   int               rc;
+   my_arrow_t *      arrow;
+
+   arrow = cnf->emitter_state;
+
+   // each CHILD_SA is a row
+   if ( (level == 3) && ((arrow->in_child)) )
+   {  arrow->in_child = 0;
+      arrow->ike_rows++;
+      return(my_fmt_arrow_row(cnf, arrow));
+   };
+
+   if ( (level == 2) && ((arrow->in_children)) )
+   {  arrow->in_children = 0;
+      return(0);
+   };
+
+   // IKE_SA without CHILD_SAs is a row with null CHILD_SA columns
+   if ( (level == 1) && (!(arrow->ike_rows)) )
+   {  if ((rc = my_fmt_arrow_reset(arrow, MY_ARROW_CHILD)) < 0)
+         return(rc);
+      return(my_fmt_arrow_row(cnf, arrow));
+   };
+
+   return(0);
+}
+
+
+int
+my_fmt_arrow_sect_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key )
+{
+   my_arrow_t *      arrow;
+   my_value_t        val;
+
+   arrow = cnf->emitter_state;
+
+   // IKE_SA section is named by the connection
+   if (level == 1)
+   {  arrow->ike_rows = 0;
+      my_fmt_arrow_reset(arrow, MY_ARROW_IKE);
+      val.data       = key;
+      val.len        = strlen(key);
+      val.is_binary  = 0;
+      return(my_fmt_arrow_cur(&arrow->cols[0], &val, 0));
+   };
+
+   if ( (level == 2) && (!(strcmp(key, "child-sas"))) )
+      arrow->in_children = 1;
+   else if ( (level == 3) && ((arrow->in_children)) )
+   {  arrow->in_child = 1;
+      my_fmt_arrow_reset(arrow, MY_ARROW_CHILD);
+   };
+
+   return(0);
+}
+
+
+/* end of source */
@@ -0,0 +1,418 @@
+/*
+ *  Davici Utilities for Strongswan
+ *  Copyright (C) 2026 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __SRC_FORMAT_CBOR_C 1
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include "davicictl.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+
+#include <davici.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+// CBOR initial bytes (RFC 8949)
+#undef   MY_CBOR_BYTES
+#define  MY_CBOR_BYTES           0x40
+#undef   MY_CBOR_TEXT
+#define  MY_CBOR_TEXT            0x60
+#undef   MY_CBOR_ARRAY_INDEF
+#define  MY_CBOR_ARRAY_INDEF     0x9f
+#undef   MY_CBOR_MAP_INDEF
+#define  MY_CBOR_MAP_INDEF       0xbf
+#undef   MY_CBOR_BREAK
+#define  MY_CBOR_BREAK           0xff
+
+
+//////////////
+//          //
+//  Macros  //
+//          //
+//////////////
+// MARK: - Macros
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+#pragma mark - Datatypes
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static int
+my_fmt_cbor_footer(
+         my_config_t *                 cnf );
+
+
+static int
+my_fmt_cbor_head(
+         my_config_t *                 cnf,
+         int                           major,
+         uint64_t                      len );
+
+
+static int
+my_fmt_cbor_key_value(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val );
+
+
+static int
+my_fmt_cbor_list_end(
+         my_config_t *                 cnf,
+         unsigned                      level );
+
+
+static int
+my_fmt_cbor_list_item(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const my_value_t *            val );
+
+
+static int
+my_fmt_cbor_list_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key );
+
+
+static int
+my_fmt_cbor_msg_end(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_cbor_msg_start(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_cbor_name(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_cbor_sect_end(
+         my_config_t *                 cnf,
+         unsigned                      level );
+
+
+static int
+my_fmt_cbor_sect_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key );
+
+
+static int
+my_fmt_cbor_string(
+         my_config_t *                 cnf,
+         int                           major,
+         const void *                  ptr,
+         size_t                        len );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+// MARK: - Variables
+
+#pragma mark my_emitter_cbor
+const my_emitter_t my_emitter_cbor =
+{  .format           = MY_FMT_CBOR,
+   .flags            = MY_EMIT_MERGE,
+   .func_footer      = &my_fmt_cbor_footer,
+   .func_key_value   = &my_fmt_cbor_key_value,
+   .func_list_end    = &my_fmt_cbor_list_end,
+   .func_list_item   = &my_fmt_cbor_list_item,
+   .func_list_start  = &my_fmt_cbor_list_start,
+   .func_msg_end     = &my_fmt_cbor_msg_end,
+   .func_msg_start   = &my_fmt_cbor_msg_start,
+   .func_sect_end    = &my_fmt_cbor_sect_end,
+   .func_sect_start  = &my_fmt_cbor_sect_start,
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+my_fmt_cbor_footer(
+         my_config_t *                 cnf )
+{
+   // replies which did not satisfy the where predicates
+   if (!(cnf->res_last_id))
+   {  my_out_putc(cnf, ((cnf->widget->flags & MY_FLG_STREAM)) ? MY_CBOR_ARRAY_INDEF : MY_CBOR_MAP_INDEF);
+      return(my_out_putc(cnf, MY_CBOR_BREAK));
+   };
+
+   // close array of streamed messages
+   if ((cnf->widget->flags & MY_FLG_STREAM))
+      return(my_out_putc(cnf, MY_CBOR_BREAK));
+
+   // close last message, map of the last socket and map of messages
+   my_out_putc(cnf, MY_CBOR_BREAK);
+   if ((cnf->sock))
+      my_out_putc(cnf, MY_CBOR_BREAK);
+   return(my_out_putc(cnf, MY_CBOR_BREAK));
+}
+
+
+int
+my_fmt_cbor_head(
+         my_config_t *                 cnf,
+         int                           major,
+         uint64_t                      len )
+{
+   int               pos;
+   int               bytes;
+   uint8_t           head[9];
+
+   // lengths below 24 are stored in the initial byte
+   if (len < 24)
+      return(my_out_putc(cnf, major | (int)len));
+
+   if      (len <= UINT8_MAX)   { head[0] = (uint8_t)(major | 24); bytes = 1; }
+   else if (len <= UINT16_MAX)  { head[0] = (uint8_t)(major | 25); bytes = 2; }
+   else if (len <= UINT32_MAX)  { head[0] = (uint8_t)(major | 26); bytes = 4; }
+   else                         { head[0] = (uint8_t)(major | 27); bytes = 8; }
+
+   // argument is stored in network byte order
+   for(pos = bytes; (pos > 0); pos--, len >>= 8)
+      head[pos] = (uint8_t)(len & 0xff);
+
+   return(my_out_write(cnf, head, (size_t)(bytes + 1)));
+}
+
+
+int
+my_fmt_cbor_key_value(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val )
+{
+   (void)level;
+
+   my_fmt_cbor_string(cnf, MY_CBOR_TEXT, key, strlen(key));
+   return(my_fmt_cbor_string(cnf, (((val->is_binary)) ? MY_CBOR_BYTES : MY_CBOR_TEXT), val->data, val->len));
+}
+
+
+int
+my_fmt_cbor_list_end(
+         my_config_t *                 cnf,
+         unsigned                      level )
+{
+   (void)level;
+
+   return(my_out_putc(cnf, MY_CBOR_BREAK));
+}
+
+
+int
+my_fmt_cbor_list_item(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const my_value_t *            val )
+{
+   (void)level;
+
+   return(my_fmt_cbor_string(cnf, (((val->is_binary)) ? MY_CBOR_BYTES : MY_CBOR_TEXT), val->data, val->len));
+}
+
+
+int
+my_fmt_cbor_list_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key )
+{
+   (void)level;
+
+   my_fmt_cbor_string(cnf, MY_CBOR_TEXT, key, strlen(key));
+   return(my_out_putc(cnf, MY_CBOR_ARRAY_INDEF));
+}
+
+
+int
+my_fmt_cbor_msg_end(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  name,
+         int                           is_event )
+{
+   (void)level;
+   (void)name;
+   (void)is_event;
+
+   // streamed messages are closed individually
+   if (!(cnf->widget->flags & MY_FLG_STREAM))
+      return(0);
+   my_out_putc(cnf, MY_CBOR_BREAK);
+   return(my_out_putc(cnf, MY_CBOR_BREAK));
+}
+
+
+int
+my_fmt_cbor_msg_start(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event )
+{
+   // streamed messages are written as an array of single entry maps
+   if ((cnf->widget->flags & MY_FLG_STREAM))
+   {  if (!(cnf->res_last_id))
+         my_out_putc(cnf, MY_CBOR_ARRAY_INDEF);
+      my_out_putc(cnf, MY_CBOR_MAP_INDEF);
+      my_fmt_cbor_name(cnf, name, is_event);
+      return(my_out_putc(cnf, MY_CBOR_MAP_INDEF));
+   };
+
+   // consecutive messages with the same name share a map
+   if (!(cnf->res_last_id))
+      my_out_putc(cnf, MY_CBOR_MAP_INDEF);
+   else if ( (cnf->res_id == cnf->res_last_id) && (cnf->sock == cnf->res_last_sock) )
+      return(0);
+   else
+      my_out_putc(cnf, MY_CBOR_BREAK);
+
+   // replies of each socket are nested in a map named after the socket
+   if (cnf->sock != cnf->res_last_sock)
+   {  if ((cnf->res_last_id))
+         my_out_putc(cnf, MY_CBOR_BREAK);
+      my_fmt_cbor_string(cnf, MY_CBOR_TEXT, cnf->sock->path, strlen(cnf->sock->path));
+      my_out_putc(cnf, MY_CBOR_MAP_INDEF);
+   };
+   my_fmt_cbor_name(cnf, name, is_event);
+   return(my_out_putc(cnf, MY_CBOR_MAP_INDEF));
+}
+
+
+int
+my_fmt_cbor_name(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event )
+{
+   size_t            len;
+
+   len = strlen(name);
+   my_fmt_cbor_head(cnf, MY_CBOR_TEXT, len + 6);
+   my_out_write(cnf, name, len);
+   return(my_out_write(cnf, (((is_event)) ? "-event" : "-reply"), 6));
+}
+
+
+int
+my_fmt_cbor_sect_end(
+         my_config_t *                 cnf,
+         unsigned                      level )
+{
+   (void)level;
+
+   return(my_out_putc(cnf, MY_CBOR_BREAK));
+}
+
+
+int
+my_fmt_cbor_sect_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key )
+{
+   (void)level;
+
+   my_fmt_cbor_string(cnf, MY_CBOR_TEXT, key, strlen(key));
+   return(my_out_putc(cnf, MY_CBOR_MAP_INDEF));
+}
+
+
+int
+my_fmt_cbor_string(
+         my_config_t *                 cnf,
+         int                           major,
+         const void *                  ptr,
+         size_t                        len )
+{
+   int               rc;
+
+   if ((rc = my_fmt_cbor_head(cnf, major, len)) < 0)
+      return(rc);
+   return(my_out_write(cnf, ptr, len));
+}
+
+
+/* end of source */
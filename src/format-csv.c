@@ -0,0 +1,738 @@
+/*
+ *  Davici Utilities for Strongswan
+ *  Copyright (C) 2026 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __SRC_FORMAT_CSV_C 1
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include "davicictl.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+
+#include <davici.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+
+//////////////
+//          //
+//  Macros  //
+//          //
+//////////////
+// MARK: - Macros
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+#pragma mark - Datatypes
+
+typedef struct _my_csv        my_csv_t;
+typedef struct _my_csv_col    my_csv_col_t;
+
+
+// column selected by dotted path
+struct _my_csv_col
+{  my_path_t                     path;
+   int                           has_cell;
+   my_buffer_t                   cell;
+};
+
+
+// state of CSV or TSV output
+struct _my_csv
+{  int                           sep;
+   int                           frozen;
+   int                           header_sent;
+   int                           records;
+   size_t                        ncols;
+   my_csv_col_t *                cols;
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static int
+my_fmt_csv_add(
+         my_csv_t *                    csv,
+         const char *                  spec );
+
+
+static int
+my_fmt_csv_cell(
+         my_csv_col_t *                col,
+         const char *                  data,
+         size_t                        len,
+         int                           is_binary );
+
+
+static char *
+my_fmt_csv_derive(
+         my_config_t *                 cnf,
+         my_csv_t *                    csv,
+         const char *                  key );
+
+
+static int
+my_fmt_csv_field(
+         my_config_t *                 cnf,
+         my_csv_t *                    csv,
+         const char *                  data,
+         size_t                        len );
+
+
+static int
+my_fmt_csv_footer(
+         my_config_t *                 cnf );
+
+
+static void
+my_fmt_csv_free(
+         my_csv_t *                    csv );
+
+
+static int
+my_fmt_csv_header(
+         my_config_t *                 cnf,
+         my_csv_t *                    csv );
+
+
+static int
+my_fmt_csv_key_value(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val );
+
+
+static int
+my_fmt_csv_leaf(
+         my_config_t *                 cnf,
+         my_csv_t *                    csv,
+         const char *                  key,
+         const my_value_t *            val );
+
+
+static int
+my_fmt_csv_list_item(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const my_value_t *            val );
+
+
+static int
+my_fmt_csv_list_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key );
+
+
+static int
+my_fmt_csv_msg_end(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_csv_msg_start(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_csv_row(
+         my_config_t *                 cnf,
+         my_csv_t *                    csv );
+
+
+static int
+my_fmt_csv_sect_end(
+         my_config_t *                 cnf,
+         unsigned                      level );
+
+
+static int
+my_fmt_csv_sect_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+// MARK: - Variables
+
+#pragma mark my_emitter_csv
+const my_emitter_t my_emitter_csv =
+{  .format           = MY_FMT_CSV,
+   .flags            = MY_EMIT_ROWS,
+   .func_footer      = &my_fmt_csv_footer,
+   .func_key_value   = &my_fmt_csv_key_value,
+   .func_list_end    = NULL,
+   .func_list_item   = &my_fmt_csv_list_item,
+   .func_list_start  = &my_fmt_csv_list_start,
+   .func_msg_end     = &my_fmt_csv_msg_end,
+   .func_msg_start   = &my_fmt_csv_msg_start,
+   .func_sect_end    = &my_fmt_csv_sect_end,
+   .func_sect_start  = &my_fmt_csv_sect_start,
+};
+
+
+#pragma mark my_emitter_tsv
+const my_emitter_t my_emitter_tsv =
+{  .format           = MY_FMT_TSV,
+   .flags            = MY_EMIT_ROWS,
+   .func_footer      = &my_fmt_csv_footer,
+   .func_key_value   = &my_fmt_csv_key_value,
+   .func_list_end    = NULL,
+   .func_list_item   = &my_fmt_csv_list_item,
+   .func_list_start  = &my_fmt_csv_list_start,
+   .func_msg_end     = &my_fmt_csv_msg_end,
+   .func_msg_start   = &my_fmt_csv_msg_start,
+   .func_sect_end    = &my_fmt_csv_sect_end,
+   .func_sect_start  = &my_fmt_csv_sect_start,
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+my_fmt_csv_add(
+         my_csv_t *                    csv,
+         const char *                  spec )
+{
+   void *            ptr;
+   my_csv_col_t *    col;
+
+   if ((ptr = realloc(csv->cols, sizeof(my_csv_col_t) * (csv->ncols + 1))) == NULL)
+      return(-ENOMEM);
+   csv->cols = ptr;
+   col       = &csv->cols[csv->ncols++];
+   memset(col, 0, sizeof(my_csv_col_t));
+
+   return(my_parse_path_compile(&col->path, spec));
+}
+
+
+int
+my_fmt_csv_cell(
+         my_csv_col_t *                col,
+         const char *                  data,
+         size_t                        len,
+         int                           is_binary )
+{
+   int               rc;
+   char *            ptr;
+   size_t            size;
+
+   // multiple matches and list items are joined into a single cell
+   if ((col->has_cell))
+   {  if ((ptr = my_buffer_alloc(&col->cell, 1)) == NULL)
+         return(-ENOMEM);
+      *ptr = ',';
+   };
+   col->has_cell = 1;
+
+   if (!(is_binary))
+   {  if (!(len))
+         return(0);
+      if ((ptr = my_buffer_alloc(&col->cell, len)) == NULL)
+         return(-ENOMEM);
+      memcpy(ptr, data, len);
+      return(0);
+   };
+
+   size = MY_BASE64_LEN(len) + 1;
+   if ((ptr = my_buffer_alloc(&col->cell, size)) == NULL)
+      return(-ENOMEM);
+   col->cell.len -= size;
+   if ((rc = my_base64_encode(ptr, size, (const uint8_t *)data, len)) < 0)
+      return(rc);
+   col->cell.len += (size_t)rc;
+
+   return(0);
+}
+
+
+char *
+my_fmt_csv_derive(
+         my_config_t *                 cnf,
+         my_csv_t *                    csv,
+         const char *                  key )
+{
+   size_t            pos;
+   size_t            len;
+   size_t            off;
+   size_t            end;
+   size_t            depth;
+   char *            str;
+   const char *      seg;
+
+   // sections nested within a record are named after items such as the
+   // CHILD_SAs of an IKE_SA, their names are replaced with wildcards so
+   // columns taken from the first row match the items of later rows
+   depth = cnf->path_offs.len / sizeof(size_t);
+   if ( (!(csv->records)) || (depth < 2) )
+      return(my_parse_path_join(cnf, key));
+
+   // the last segment of the path of a list item is the name of the list
+   end = ((key)) ? depth : (depth - 1);
+
+   len = ((key)) ? (strlen(key) + 1) : 0;
+   for(pos = 0; (pos < depth); pos++)
+   {  memcpy(&off, &cnf->path_offs.data[pos * sizeof(size_t)], sizeof(size_t));
+      len += ( ((pos)) && (pos < end) ) ? 2 : (strlen(&cnf->path.data[off]) + 1);
+   };
+   if ((str = malloc(len)) == NULL)
+      return(NULL);
+
+   len = 0;
+   for(pos = 0; (pos <= depth); pos++)
+   {  if (pos == depth)
+      {  if (!(seg = key))
+            break;
+      } else if ( ((pos)) && (pos < end) )
+      {  seg = "*";
+      } else
+      {  memcpy(&off, &cnf->path_offs.data[pos * sizeof(size_t)], sizeof(size_t));
+         seg = &cnf->path.data[off];
+      };
+      if ((pos))
+         str[len++] = '.';
+      strcpy(&str[len], seg);
+      len += strlen(seg);
+   };
+
+   return(str);
+}
+
+
+int
+my_fmt_csv_field(
+         my_config_t *                 cnf,
+         my_csv_t *                    csv,
+         const char *                  data,
+         size_t                        len )
+{
+   int               rc;
+   size_t            pos;
+   size_t            span;
+
+   // TSV escapes separators and line breaks
+   if (csv->sep == '\t')
+   {  for(pos = 0; (pos < len); pos += span + 1)
+      {  for(span = 0; ((pos + span) < len); span++)
+            if (strchr("\t\n\r\\", data[pos+span]) != NULL)
+               break;
+         if ((span))
+            if ((rc = my_out_write(cnf, &data[pos], span)) < 0)
+               return(rc);
+         if ((pos + span) == len)
+            break;
+         switch(data[pos+span])
+         {  case '\t': rc = my_out_write(cnf, "\\t",  2); break;
+            case '\n': rc = my_out_write(cnf, "\\n",  2); break;
+            case '\r': rc = my_out_write(cnf, "\\r",  2); break;
+            default:   rc = my_out_write(cnf, "\\\\", 2); break;
+         };
+         if (rc < 0)
+            return(rc);
+      };
+      return(0);
+   };
+
+   // CSV quotes fields containing separators, quotes or line breaks (RFC 4180)
+   for(pos = 0; (pos < len); pos++)
+      if (strchr(",\"\r\n", data[pos]) != NULL)
+         break;
+   if (pos == len)
+      return(((len)) ? my_out_write(cnf, data, len) : 0);
+
+   if ((rc = my_out_putc(cnf, '"')) < 0)
+      return(rc);
+   for(pos = 0; (pos < len); pos += span + 1)
+   {  for(span = 0; ((pos + span) < len); span++)
+         if (data[pos+span] == '"')
+            break;
+      if ((rc = my_out_write(cnf, &data[pos], (((pos + span) < len)) ? (span + 1) : span)) < 0)
+         return(rc);
+      if ((pos + span) < len)
+         if ((rc = my_out_putc(cnf, '"')) < 0)
+            return(rc);
+   };
+
+   return(my_out_putc(cnf, '"'));
+}
+
+
+int
+my_fmt_csv_footer(
+         my_config_t *                 cnf )
+{
+   int               rc;
+   my_csv_t *        csv;
+
+   // selected columns are listed even if no rows were returned
+   if (!(cnf->emitter_state))
+      if ((rc = my_fmt_csv_msg_start(cnf, "", 0)) < 0)
+         return(rc);
+   if ((csv = cnf->emitter_state) == NULL)
+      return(0);
+
+   rc = 0;
+   if ( (!(csv->header_sent)) && ((csv->frozen)) )
+      rc = my_fmt_csv_header(cnf, csv);
+
+   my_fmt_csv_free(csv);
+   cnf->emitter_state = NULL;
+
+   return(rc);
+}
+
+
+void
+my_fmt_csv_free(
+         my_csv_t *                    csv )
+{
+   size_t            pos;
+
+   if (!(csv))
+      return;
+
+   for(pos = 0; (pos < csv->ncols); pos++)
+   {  my_parse_path_free(&csv->cols[pos].path);
+      my_buffer_free(&csv->cols[pos].cell);
+   };
+   free(csv->cols);
+   free(csv);
+
+   return;
+}
+
+
+int
+my_fmt_csv_header(
+         my_config_t *                 cnf,
+         my_csv_t *                    csv )
+{
+   int               rc;
+   size_t            pos;
+
+   for(pos = 0; (pos < csv->ncols); pos++)
+   {  if ((pos))
+         if ((rc = my_out_putc(cnf, csv->sep)) < 0)
+            return(rc);
+      if ((rc = my_fmt_csv_field(cnf, csv, csv->cols[pos].path.spec, strlen(csv->cols[pos].path.spec))) < 0)
+         return(rc);
+   };
+   csv->header_sent = 1;
+
+   return(my_out_putc(cnf, '\n'));
+}
+
+
+int
+my_fmt_csv_key_value(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val )
+{
+   my_csv_t *        csv;
+
+   csv = cnf->emitter_state;
+
+   // keys outside of records are not part of any row
+   if ( ((csv->records)) && (level == 1) )
+      return(0);
+
+   return(my_fmt_csv_leaf(cnf, csv, key, val));
+}
+
+
+int
+my_fmt_csv_leaf(
+         my_config_t *                 cnf,
+         my_csv_t *                    csv,
+         const char *                  key,
+         const my_value_t *            val )
+{
+   int               rc;
+   int               matched;
+   char *            spec;
+   size_t            pos;
+
+   matched = 0;
+   for(pos = 0; (pos < csv->ncols); pos++)
+   {  if (!(my_parse_path_match(cnf, &csv->cols[pos].path, key, 0)))
+         continue;
+      if ((rc = my_fmt_csv_cell(&csv->cols[pos], val->data, val->len, val->is_binary)) < 0)
+         return(rc);
+      matched = 1;
+   };
+   if ( ((matched)) || ((csv->frozen)) )
+      return(0);
+
+   // without a column selection, the columns are taken from the first row
+   if ((spec = my_fmt_csv_derive(cnf, csv, key)) == NULL)
+      return(-ENOMEM);
+   rc = my_fmt_csv_add(csv, spec);
+   free(spec);
+   if (rc < 0)
+      return(rc);
+
+   return(my_fmt_csv_cell(&csv->cols[csv->ncols-1], val->data, val->len, val->is_binary));
+}
+
+
+int
+my_fmt_csv_list_item(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const my_value_t *            val )
+{
+   (void)level;
+   return(my_fmt_csv_leaf(cnf, cnf->emitter_state, NULL, val));
+}
+
+
+int
+my_fmt_csv_list_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key )
+{
+   size_t            pos;
+   my_csv_t *        csv;
+
+   (void)key;
+
+   csv = cnf->emitter_state;
+
+   if ( ((csv->records)) && (level == 1) )
+      return(MY_EMIT_SKIP);
+   if (!(csv->frozen))
+      return(0);
+
+   // skip lists which are not selected
+   for(pos = 0; (pos < csv->ncols); pos++)
+      if ((my_parse_path_match(cnf, &csv->cols[pos].path, NULL, 0)))
+         return(0);
+
+   return(MY_EMIT_SKIP);
+}
+
+
+int
+my_fmt_csv_msg_end(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  name,
+         int                           is_event )
+{
+   my_csv_t *        csv;
+
+   (void)level;
+   (void)name;
+   (void)is_event;
+
+   csv = cnf->emitter_state;
+   if ((csv->records))
+      return(0);
+
+   return(my_fmt_csv_row(cnf, csv));
+}
+
+
+int
+my_fmt_csv_msg_start(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event )
+{
+   int               rc;
+   char *            fields;
+   char *            spec;
+   char *            last;
+   my_csv_t *        csv;
+
+   (void)name;
+   (void)is_event;
+
+   if ((cnf->emitter_state))
+      return(0);
+
+   if ((csv = calloc(1, sizeof(my_csv_t))) == NULL)
+      return(-ENOMEM);
+   cnf->emitter_state = csv;
+   csv->sep       = (cnf->format_out == MY_FMT_TSV) ? '\t' : ',';
+   csv->records   = (((cnf->flags | cnf->widget->flags) & MY_FLG_RECORDS)) ? 1 : 0;
+
+   if (!(cnf->opt_fields))
+      return(0);
+
+   // compile column selection
+   if ((fields = strdup(cnf->opt_fields)) == NULL)
+      return(-ENOMEM);
+   for(spec = strtok_r(fields, ",", &last); ((spec)); spec = strtok_r(NULL, ",", &last))
+   {  if ((rc = my_fmt_csv_add(csv, spec)) < 0)
+      {  if (rc == -EINVAL)
+            fprintf(stderr, "%s: invalid column `%s'\n", my_prog_name(cnf), spec);
+         free(fields);
+         return(rc);
+      };
+   };
+   free(fields);
+   csv->frozen = 1;
+
+   return(0);
+}
+
+
+int
+my_fmt_csv_row(
+         my_config_t *                 cnf,
+         my_csv_t *                    csv )
+{
+   int               rc;
+   size_t            pos;
+   my_csv_col_t *    col;
+
+   csv->frozen = 1;
+   if (!(csv->header_sent))
+      if ((rc = my_fmt_csv_header(cnf, csv)) < 0)
+         return(rc);
+
+   for(pos = 0; (pos < csv->ncols); pos++)
+   {  col = &csv->cols[pos];
+      if ((pos))
+         if ((rc = my_out_putc(cnf, csv->sep)) < 0)
+            return(rc);
+      if ((rc = my_fmt_csv_field(cnf, csv, col->cell.data, col->cell.len)) < 0)
+         return(rc);
+      col->cell.len  = 0;
+      col->has_cell  = 0;
+   };
+   if ((rc = my_out_putc(cnf, '\n')) < 0)
+      return(rc);
+
+   if ((cnf->widget->flags & MY_FLG_STREAM))
+      return(my_out_flush(cnf));
+
+   return(0);
+}
+
+
+int
+my_fmt_csv_sect_end(
+         my_config_t *                 cnf,
+         unsigned                      level )
+{
+   my_csv_t *        csv;
+
+   csv = cnf->emitter_state;
+
+   // each top level section of a record widget is a row
+   if ( ((csv->records)) && (level == 1) )
+      return(my_fmt_csv_row(cnf, csv));
+
+   return(0);
+}
+
+
+int
+my_fmt_csv_sect_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key )
+{
+   size_t            pos;
+   my_csv_t *        csv;
+   my_value_t        val;
+
+   csv = cnf->emitter_state;
+
+   // name of record is available as column "name"
+   if ( ((csv->records)) && (level == 1) )
+   {  val.data       = key;
+      val.len        = strlen(key);
+      val.is_binary  = 0;
+      return(my_fmt_csv_leaf(cnf, csv, "name", &val));
+   };
+   if (!(csv->frozen))
+      return(0);
+
+   // skip subtrees which do not contain a selected column
+   for(pos = 0; (pos < csv->ncols); pos++)
+      if ((my_parse_path_match(cnf, &csv->cols[pos].path, NULL, 1)))
+         return(0);
+
+   return(MY_EMIT_SKIP);
+}
+
+
+/* end of source */
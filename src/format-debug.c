@@ -0,0 +1,301 @@
+/*
+ *  Davici Utilities for Strongswan
+ *  Copyright (C) 2026 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __SRC_FORMAT_DEBUG_C 1
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include "davicictl.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+
+#include <davici.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+
+//////////////
+//          //
+//  Macros  //
+//          //
+//////////////
+// MARK: - Macros
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+#pragma mark - Datatypes
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static int
+my_fmt_debug_key_value(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val );
+
+
+static int
+my_fmt_debug_list_end(
+         my_config_t *                 cnf,
+         unsigned                      level );
+
+
+static int
+my_fmt_debug_list_item(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const my_value_t *            val );
+
+
+static int
+my_fmt_debug_list_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key );
+
+
+static int
+my_fmt_debug_msg_end(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_debug_msg_start(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_debug_print(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  name,
+         const char *                  key,
+         const my_value_t *            val );
+
+
+static int
+my_fmt_debug_sect_end(
+         my_config_t *                 cnf,
+         unsigned                      level );
+
+
+static int
+my_fmt_debug_sect_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+// MARK: - Variables
+
+#pragma mark my_emitter_debug
+const my_emitter_t my_emitter_debug =
+{  .format           = MY_FMT_DEBUG,
+   .flags            = 0,
+   .func_footer      = NULL,
+   .func_key_value   = &my_fmt_debug_key_value,
+   .func_list_end    = &my_fmt_debug_list_end,
+   .func_list_item   = &my_fmt_debug_list_item,
+   .func_list_start  = &my_fmt_debug_list_start,
+   .func_msg_end     = &my_fmt_debug_msg_end,
+   .func_msg_start   = &my_fmt_debug_msg_start,
+   .func_sect_end    = &my_fmt_debug_sect_end,
+   .func_sect_start  = &my_fmt_debug_sect_start,
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+my_fmt_debug_key_value(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val )
+{
+   return(my_fmt_debug_print(cnf, level, "DAVICI_KEY_VALUE", key, val));
+}
+
+
+int
+my_fmt_debug_list_end(
+         my_config_t *                 cnf,
+         unsigned                      level )
+{
+   return(my_fmt_debug_print(cnf, level+1, "DAVICI_LIST_END", NULL, NULL));
+}
+
+
+int
+my_fmt_debug_list_item(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const my_value_t *            val )
+{
+   return(my_fmt_debug_print(cnf, level, "DAVICI_LIST_ITEM", NULL, val));
+}
+
+
+int
+my_fmt_debug_list_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key )
+{
+   return(my_fmt_debug_print(cnf, level, "DAVICI_LIST_START", key, NULL));
+}
+
+
+int
+my_fmt_debug_msg_end(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  name,
+         int                           is_event )
+{
+   (void)name;
+   (void)is_event;
+
+   return(my_fmt_debug_print(cnf, level, "DAVICI_END", NULL, NULL));
+}
+
+
+int
+my_fmt_debug_msg_start(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event )
+{
+   char              title[64];
+
+   my_strlcpy(title, "VICI ", sizeof(title));
+   my_strlcat(title, (((is_event)) ? "Event" : "Reply"), sizeof(title));
+   return(my_fmt_debug_print(cnf, 0, title, name, NULL));
+}
+
+
+int
+my_fmt_debug_print(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  name,
+         const char *                  key,
+         const my_value_t *            val )
+{
+   size_t len;
+   char   buff[64];
+
+   my_strlcpy(buff, name,  sizeof(buff));
+   len = my_strlcat(buff, ":",   sizeof(buff));
+   len = (len < sizeof(buff)) ? len : (sizeof(buff) - 1);
+
+   my_out_write(cnf, buff, len);
+   if ( (!(key)) && (!(val)) )
+      return(my_out_putc(cnf, '\n'));
+   my_out_indent(cnf, ((len < 24) ? (24 - len) : 0) + (level*cnf->out_indent));
+   if (!(key))
+   {  my_out_value(cnf, val);
+      return(my_out_putc(cnf, '\n'));
+   };
+   my_out_puts(cnf, key);
+   if ((val))
+   {  my_out_write(cnf, " = \"", 4);
+      my_out_value(cnf, val);
+      my_out_putc(cnf, '"');
+   };
+   return(my_out_putc(cnf, '\n'));
+}
+
+
+int
+my_fmt_debug_sect_end(
+         my_config_t *                 cnf,
+         unsigned                      level )
+{
+   return(my_fmt_debug_print(cnf, level+1, "DAVICI_SECTION_END", NULL, NULL));
+}
+
+
+int
+my_fmt_debug_sect_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key )
+{
+   return(my_fmt_debug_print(cnf, level, "DAVICI_SECTION_START", key, NULL));
+}
+
+
+/* end of source */
@@ -0,0 +1,472 @@
+/*
+ *  Davici Utilities for Strongswan
+ *  Copyright (C) 2026 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __SRC_FORMAT_JSON_C 1
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include "davicictl.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+
+#include <davici.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+
+//////////////
+//          //
+//  Macros  //
+//          //
+//////////////
+// MARK: - Macros
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+#pragma mark - Datatypes
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static int
+my_fmt_json_delim(
+         my_config_t *                 cnf,
+         unsigned                      level );
+
+
+static int
+my_fmt_json_footer(
+         my_config_t *                 cnf );
+
+
+static int
+my_fmt_json_key_value(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val );
+
+
+static int
+my_fmt_json_list_end(
+         my_config_t *                 cnf,
+         unsigned                      level );
+
+
+static int
+my_fmt_json_list_item(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const my_value_t *            val );
+
+
+static int
+my_fmt_json_list_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key );
+
+
+static int
+my_fmt_json_msg_end(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_json_msg_start(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_json_name(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_json_sect_end(
+         my_config_t *                 cnf,
+         unsigned                      level );
+
+
+static int
+my_fmt_json_sect_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key );
+
+
+static int
+my_fmt_json_sock(
+         my_config_t *                 cnf );
+
+
+static int
+my_fmt_ndjson_msg_end(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_ndjson_msg_start(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+// MARK: - Variables
+
+#pragma mark my_emitter_json
+const my_emitter_t my_emitter_json =
+{  .format           = MY_FMT_JSON,
+   .flags            = MY_EMIT_MERGE,
+   .func_footer      = &my_fmt_json_footer,
+   .func_key_value   = &my_fmt_json_key_value,
+   .func_list_end    = &my_fmt_json_list_end,
+   .func_list_item   = &my_fmt_json_list_item,
+   .func_list_start  = &my_fmt_json_list_start,
+   .func_msg_end     = &my_fmt_json_msg_end,
+   .func_msg_start   = &my_fmt_json_msg_start,
+   .func_sect_end    = &my_fmt_json_sect_end,
+   .func_sect_start  = &my_fmt_json_sect_start,
+};
+
+
+#pragma mark my_emitter_ndjson
+const my_emitter_t my_emitter_ndjson =
+{  .format           = MY_FMT_NDJSON,
+   .flags            = 0,
+   .func_footer      = NULL,
+   .func_key_value   = &my_fmt_json_key_value,
+   .func_list_end    = &my_fmt_json_list_end,
+   .func_list_item   = &my_fmt_json_list_item,
+   .func_list_start  = &my_fmt_json_list_start,
+   .func_msg_end     = &my_fmt_ndjson_msg_end,
+   .func_msg_start   = &my_fmt_ndjson_msg_start,
+   .func_sect_end    = &my_fmt_json_sect_end,
+   .func_sect_start  = &my_fmt_json_sect_start,
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+my_fmt_json_delim(
+         my_config_t *                 cnf,
+         unsigned                      level )
+{
+   // replies of multiple sockets are nested within a section of the socket
+   level += ( ((cnf->sock)) && (!(cnf->widget->flags & MY_FLG_STREAM)) ) ? 2 : 1;
+   if ((cnf->flags & MY_FLG_PRETTY))
+      return(my_out_delim(cnf, (((cnf->last_was_item)) ? MY_OUT_DELIM_COMMA : MY_OUT_DELIM_NEWLINE), level));
+   if ((cnf->last_was_item))
+      return(my_out_write(cnf, ", ", 2));
+   return(0);
+}
+
+
+int
+my_fmt_json_footer(
+         my_config_t *                 cnf )
+{
+   // replies which did not satisfy the where predicates
+   if (!(cnf->res_last_id))
+      return(my_out_puts(cnf, ((cnf->widget->flags & MY_FLG_STREAM)) ? "[]\n" : "{}\n"));
+
+   if ((cnf->widget->flags & MY_FLG_STREAM))
+      return(my_out_puts(cnf, ((cnf->flags & MY_FLG_PRETTY)) ? "\n]\n" : "]\n"));
+
+   // close last message within the section of the last socket
+   if ((cnf->sock))
+   {  cnf->last_was_item = 0;
+      my_fmt_json_delim(cnf, 0);
+      my_out_putc(cnf, '}');
+   };
+   return(my_out_puts(cnf, ((cnf->flags & MY_FLG_PRETTY)) ? "\n   }\n}\n" : "}}\n"));
+}
+
+
+int
+my_fmt_json_key_value(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val )
+{
+   my_fmt_json_delim(cnf, level);
+   my_out_putc(cnf, '"');
+   my_out_json(cnf, key, strlen(key));
+   my_out_write(cnf, "\": \"", 4);
+   my_out_json_value(cnf, val);
+   cnf->last_was_item = 1;
+   return(my_out_putc(cnf, '"'));
+}
+
+
+int
+my_fmt_json_list_end(
+         my_config_t *                 cnf,
+         unsigned                      level )
+{
+   cnf->last_was_item = 0;
+   my_fmt_json_delim(cnf, level);
+   cnf->last_was_item = 1;
+   return(my_out_putc(cnf, ']'));
+}
+
+
+int
+my_fmt_json_list_item(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const my_value_t *            val )
+{
+   my_fmt_json_delim(cnf, level);
+   my_out_putc(cnf, '"');
+   my_out_json_value(cnf, val);
+   cnf->last_was_item = 1;
+   return(my_out_putc(cnf, '"'));
+}
+
+
+int
+my_fmt_json_list_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key )
+{
+   my_fmt_json_delim(cnf, level);
+   my_out_putc(cnf, '"');
+   my_out_json(cnf, key, strlen(key));
+   cnf->last_was_item = 0;
+   return(my_out_write(cnf, "\": [", 4));
+}
+
+
+int
+my_fmt_json_msg_end(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  name,
+         int                           is_event )
+{
+   (void)name;
+   (void)is_event;
+
+   // messages merged into a shared section may not contain elements
+   if ((cnf->widget->flags & MY_FLG_STREAM))
+   {  cnf->last_was_item = 0;
+      my_fmt_json_delim(cnf, level);
+      my_out_write(cnf, "}}", 2);
+      cnf->last_was_item = 1;
+   };
+   return(0);
+}
+
+
+int
+my_fmt_json_msg_start(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event )
+{
+   // print JSON header
+   if (!(cnf->res_last_id))
+      my_out_putc(cnf, ((cnf->widget->flags & MY_FLG_STREAM)) ? '[' : '{');
+
+   // print event/command section start
+   if ((cnf->widget->flags & MY_FLG_STREAM))
+   {  my_fmt_json_delim(cnf, 0);
+      my_out_putc(cnf, '{');
+      my_fmt_json_name(cnf, name, is_event);
+      cnf->last_was_item = 0;
+      return(0);
+   };
+
+   // consecutive messages with the same name share a section
+   if ( (cnf->res_id == cnf->res_last_id) && (cnf->sock == cnf->res_last_sock) )
+      return(0);
+   cnf->last_was_item = 0;
+   if ((cnf->res_last_id))
+   {  my_fmt_json_delim(cnf, 0);
+      my_out_putc(cnf, '}');
+      cnf->last_was_item = 1;
+   };
+   if (cnf->sock != cnf->res_last_sock)
+      my_fmt_json_sock(cnf);
+   my_fmt_json_delim(cnf, 0);
+   my_fmt_json_name(cnf, name, is_event);
+   cnf->last_was_item = 0;
+
+   return(0);
+}
+
+
+int
+my_fmt_json_name(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event )
+{
+   my_out_putc(cnf, '"');
+   my_out_json(cnf, name, strlen(name));
+   return(my_out_puts(cnf, (((is_event)) ? "-event\": {" : "-reply\": {")));
+}
+
+
+int
+my_fmt_json_sect_end(
+         my_config_t *                 cnf,
+         unsigned                      level )
+{
+   cnf->last_was_item = 0;
+   my_fmt_json_delim(cnf, level);
+   cnf->last_was_item = 1;
+   return(my_out_putc(cnf, '}'));
+}
+
+
+int
+my_fmt_json_sect_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key )
+{
+   my_fmt_json_delim(cnf, level);
+   my_out_putc(cnf, '"');
+   my_out_json(cnf, key, strlen(key));
+   cnf->last_was_item = 0;
+   return(my_out_write(cnf, "\": {", 4));
+}
+
+
+int
+my_fmt_json_sock(
+         my_config_t *                 cnf )
+{
+   int               delim;
+
+   // replies of each socket are nested in a section named after the
+   // socket, which is indented at the level of messages
+   if ((cnf->res_last_id))
+   {  if ((cnf->flags & MY_FLG_PRETTY))
+         my_out_delim(cnf, MY_OUT_DELIM_NEWLINE, 1);
+      my_out_putc(cnf, '}');
+   };
+   delim = ((cnf->res_last_id)) ? MY_OUT_DELIM_COMMA : MY_OUT_DELIM_NEWLINE;
+   if ((cnf->flags & MY_FLG_PRETTY))
+      my_out_delim(cnf, delim, 1);
+   else if ((cnf->res_last_id))
+      my_out_write(cnf, ", ", 2);
+   my_out_putc(cnf, '"');
+   my_out_json(cnf, cnf->sock->path, strlen(cnf->sock->path));
+   cnf->last_was_item = 0;
+   return(my_out_write(cnf, "\": {", 4));
+}
+
+
+int
+my_fmt_ndjson_msg_end(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  name,
+         int                           is_event )
+{
+   (void)level;
+   (void)name;
+   (void)is_event;
+
+   cnf->last_was_item = 1;
+   my_out_write(cnf, "}}\n", 3);
+   return(my_out_flush(cnf));
+}
+
+
+int
+my_fmt_ndjson_msg_start(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event )
+{
+   // each message is a compact JSON object on a single line
+   cnf->flags         &= ~MY_FLG_PRETTY;
+   cnf->last_was_item  = 0;
+   my_out_putc(cnf, '{');
+   return(my_fmt_json_name(cnf, name, is_event));
+}
+
+
+/* end of source */
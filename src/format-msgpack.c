@@ -0,0 +1,473 @@
+/*
+ *  Davici Utilities for Strongswan
+ *  Copyright (C) 2026 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __SRC_FORMAT_MSGPACK_C 1
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include "davicictl.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+
+#include <davici.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+// MessagePack type bytes
+#undef   MY_MSGPACK_FIXMAP
+#define  MY_MSGPACK_FIXMAP       0x80
+#undef   MY_MSGPACK_FIXSTR
+#define  MY_MSGPACK_FIXSTR       0xa0
+#undef   MY_MSGPACK_BIN8
+#define  MY_MSGPACK_BIN8         0xc4
+#undef   MY_MSGPACK_STR8
+#define  MY_MSGPACK_STR8         0xd9
+#undef   MY_MSGPACK_ARRAY32
+#define  MY_MSGPACK_ARRAY32      0xdd
+#undef   MY_MSGPACK_MAP32
+#define  MY_MSGPACK_MAP32        0xdf
+
+
+//////////////
+//          //
+//  Macros  //
+//          //
+//////////////
+// MARK: - Macros
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+#pragma mark - Datatypes
+
+typedef struct _my_msgpack_cont my_msgpack_cont_t;
+
+
+// open map or array awaiting its element count
+struct _my_msgpack_cont
+{  size_t                        offset;
+   uint32_t                      count;
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static uint8_t *
+my_fmt_msgpack_alloc(
+         my_config_t *                 cnf,
+         size_t                        len );
+
+
+static int
+my_fmt_msgpack_close(
+         my_config_t *                 cnf );
+
+
+static void
+my_fmt_msgpack_count(
+         my_config_t *                 cnf );
+
+
+static int
+my_fmt_msgpack_key_value(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val );
+
+
+static int
+my_fmt_msgpack_list_end(
+         my_config_t *                 cnf,
+         unsigned                      level );
+
+
+static int
+my_fmt_msgpack_list_item(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const my_value_t *            val );
+
+
+static int
+my_fmt_msgpack_list_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key );
+
+
+static int
+my_fmt_msgpack_msg_end(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_msgpack_msg_start(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_msgpack_open(
+         my_config_t *                 cnf,
+         int                           type );
+
+
+static int
+my_fmt_msgpack_sect_end(
+         my_config_t *                 cnf,
+         unsigned                      level );
+
+
+static int
+my_fmt_msgpack_sect_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key );
+
+
+static int
+my_fmt_msgpack_str(
+         my_config_t *                 cnf,
+         int                           is_binary,
+         const void *                  src,
+         size_t                        len,
+         const char *                  suffix );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+// MARK: - Variables
+
+#pragma mark my_emitter_msgpack
+const my_emitter_t my_emitter_msgpack =
+{  .format           = MY_FMT_MSGPACK,
+   .flags            = 0,
+   .func_footer      = NULL,
+   .func_key_value   = &my_fmt_msgpack_key_value,
+   .func_list_end    = &my_fmt_msgpack_list_end,
+   .func_list_item   = &my_fmt_msgpack_list_item,
+   .func_list_start  = &my_fmt_msgpack_list_start,
+   .func_msg_end     = &my_fmt_msgpack_msg_end,
+   .func_msg_start   = &my_fmt_msgpack_msg_start,
+   .func_sect_end    = &my_fmt_msgpack_sect_end,
+   .func_sect_start  = &my_fmt_msgpack_sect_start,
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+uint8_t *
+my_fmt_msgpack_alloc(
+         my_config_t *                 cnf,
+         size_t                        len )
+{
+   uint8_t *         ptr;
+
+   if ((ptr = my_buffer_alloc(&cnf->msg_buff, len)) == NULL)
+      fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+
+   return(ptr);
+}
+
+
+int
+my_fmt_msgpack_close(
+         my_config_t *                 cnf )
+{
+   uint8_t *               ptr;
+   my_msgpack_cont_t *     cont;
+
+   assert(cnf->msg_stack.len >= sizeof(my_msgpack_cont_t));
+
+   // store final number of elements in the reserved 32-bit header
+   cnf->msg_stack.len -= sizeof(my_msgpack_cont_t);
+   cont  = (my_msgpack_cont_t *)&cnf->msg_stack.data[cnf->msg_stack.len];
+   ptr   = (uint8_t *)&cnf->msg_buff.data[cont->offset];
+   ptr[1] = (uint8_t)((cont->count >> 24) & 0xff);
+   ptr[2] = (uint8_t)((cont->count >> 16) & 0xff);
+   ptr[3] = (uint8_t)((cont->count >>  8) & 0xff);
+   ptr[4] = (uint8_t)((cont->count >>  0) & 0xff);
+
+   return(0);
+}
+
+
+void
+my_fmt_msgpack_count(
+         my_config_t *                 cnf )
+{
+   my_msgpack_cont_t *     cont;
+
+   if (cnf->msg_stack.len < sizeof(my_msgpack_cont_t))
+      return;
+   cont = (my_msgpack_cont_t *)&cnf->msg_stack.data[cnf->msg_stack.len - sizeof(my_msgpack_cont_t)];
+   cont->count++;
+
+   return;
+}
+
+
+int
+my_fmt_msgpack_key_value(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val )
+{
+   int               rc;
+
+   (void)level;
+
+   my_fmt_msgpack_count(cnf);
+   if ((rc = my_fmt_msgpack_str(cnf, 0, key, strlen(key), NULL)) < 0)
+      return(rc);
+   return(my_fmt_msgpack_str(cnf, val->is_binary, val->data, val->len, NULL));
+}
+
+
+int
+my_fmt_msgpack_list_end(
+         my_config_t *                 cnf,
+         unsigned                      level )
+{
+   (void)level;
+
+   return(my_fmt_msgpack_close(cnf));
+}
+
+
+int
+my_fmt_msgpack_list_item(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const my_value_t *            val )
+{
+   (void)level;
+
+   my_fmt_msgpack_count(cnf);
+   return(my_fmt_msgpack_str(cnf, val->is_binary, val->data, val->len, NULL));
+}
+
+
+int
+my_fmt_msgpack_list_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key )
+{
+   int               rc;
+
+   (void)level;
+
+   my_fmt_msgpack_count(cnf);
+   if ((rc = my_fmt_msgpack_str(cnf, 0, key, strlen(key), NULL)) < 0)
+      return(rc);
+   return(my_fmt_msgpack_open(cnf, MY_MSGPACK_ARRAY32));
+}
+
+
+int
+my_fmt_msgpack_msg_end(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  name,
+         int                           is_event )
+{
+   int               rc;
+
+   (void)level;
+   (void)name;
+   (void)is_event;
+
+   if ((rc = my_fmt_msgpack_close(cnf)) < 0)
+      return(rc);
+
+   return(my_out_write(cnf, cnf->msg_buff.data, cnf->msg_buff.len));
+}
+
+
+int
+my_fmt_msgpack_msg_start(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event )
+{
+   int               rc;
+   uint8_t *         ptr;
+
+   // each message is encoded as a single entry map keyed by message name
+   cnf->msg_buff.len    = 0;
+   cnf->msg_stack.len   = 0;
+   if ((ptr = my_fmt_msgpack_alloc(cnf, 1)) == NULL)
+      return(-ENOMEM);
+   *ptr = MY_MSGPACK_FIXMAP | 1;
+
+   if ((rc = my_fmt_msgpack_str(cnf, 0, name, strlen(name), (((is_event)) ? "-event" : "-reply"))) < 0)
+      return(rc);
+
+   return(my_fmt_msgpack_open(cnf, MY_MSGPACK_MAP32));
+}
+
+
+int
+my_fmt_msgpack_open(
+         my_config_t *                 cnf,
+         int                           type )
+{
+   uint8_t *               ptr;
+   my_msgpack_cont_t *     cont;
+
+   // reserve a 32-bit header which is updated once the container is closed
+   if ((ptr = my_fmt_msgpack_alloc(cnf, 5)) == NULL)
+      return(-ENOMEM);
+   ptr[0] = (uint8_t)type;
+
+   if ((cont = my_buffer_alloc(&cnf->msg_stack, sizeof(my_msgpack_cont_t))) == NULL)
+   {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      return(-ENOMEM);
+   };
+   cont->offset   = (size_t)(ptr - (uint8_t *)cnf->msg_buff.data);
+   cont->count    = 0;
+
+   return(0);
+}
+
+
+int
+my_fmt_msgpack_sect_end(
+         my_config_t *                 cnf,
+         unsigned                      level )
+{
+   (void)level;
+
+   return(my_fmt_msgpack_close(cnf));
+}
+
+
+int
+my_fmt_msgpack_sect_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key )
+{
+   int               rc;
+
+   (void)level;
+
+   my_fmt_msgpack_count(cnf);
+   if ((rc = my_fmt_msgpack_str(cnf, 0, key, strlen(key), NULL)) < 0)
+      return(rc);
+   return(my_fmt_msgpack_open(cnf, MY_MSGPACK_MAP32));
+}
+
+
+int
+my_fmt_msgpack_str(
+         my_config_t *                 cnf,
+         int                           is_binary,
+         const void *                  src,
+         size_t                        len,
+         const char *                  suffix )
+{
+   int               pos;
+   int               type;
+   int               bytes;
+   uint8_t *         ptr;
+   uint8_t           head[5];
+   size_t            slen;
+   size_t            total;
+
+   slen  = ((suffix)) ? strlen(suffix) : 0;
+   total = len + slen;
+
+   // str and bin types share layout for 8, 16 and 32-bit lengths
+   type  = ((is_binary)) ? MY_MSGPACK_BIN8 : MY_MSGPACK_STR8;
+   if ( (!(is_binary)) && (total < 32) )
+   {  head[0] = (uint8_t)(MY_MSGPACK_FIXSTR | total);
+      bytes = 0;
+   }
+   else if (total <= UINT8_MAX)  { head[0] = (uint8_t)(type + 0); bytes = 1; }
+   else if (total <= UINT16_MAX) { head[0] = (uint8_t)(type + 1); bytes = 2; }
+   else                          { head[0] = (uint8_t)(type + 2); bytes = 4; }
+   for(pos = bytes; (pos > 0); pos--)
+      head[pos] = (uint8_t)((total >> ((bytes - pos) * 8)) & 0xff);
+
+   if ((ptr = my_fmt_msgpack_alloc(cnf, (size_t)(bytes + 1) + total)) == NULL)
+      return(-ENOMEM);
+   memcpy(ptr, head, (size_t)(bytes + 1));
+   memcpy(&ptr[bytes + 1], src, len);
+   if ((slen))
+      memcpy(&ptr[(size_t)(bytes + 1) + len], suffix, slen);
+
+   return(0);
+}
+
+
+/* end of source */
@@ -0,0 +1,750 @@
+/*
+ *  Davici Utilities for Strongswan
+ *  Copyright (C) 2026 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __SRC_FORMAT_OPENMETRICS_C 1
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include "davicictl.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+
+#include <davici.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#undef   MY_OM_NUM_MAX
+#define  MY_OM_NUM_MAX        64
+
+
+//////////////
+//          //
+//  Macros  //
+//          //
+//////////////
+// MARK: - Macros
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+#pragma mark - Datatypes
+
+typedef struct _my_om         my_om_t;
+typedef struct _my_om_family  my_om_family_t;
+typedef struct _my_om_metric  my_om_metric_t;
+
+
+// mapping of reply element to metric family
+struct _my_om_metric
+{  const char *                  msg;
+   const char *                  path;
+   const char *                  name;
+   const char *                  type;
+   const char *                  labels;
+   const char *                  help;
+};
+
+
+// samples of metric family
+struct _my_om_family
+{  char *                        name;
+   const my_om_metric_t *        metric;
+   my_buffer_t                   samples;
+};
+
+
+// state of OpenMetrics output
+struct _my_om
+{  int                           records;
+   size_t                        first;
+   size_t                        last;
+   my_path_t *                   paths;
+   size_t                        nfamilies;
+   my_om_family_t *              families;
+   my_buffer_t                   name;
+   my_buffer_t                   record;
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static my_om_family_t *
+my_fmt_om_family(
+         my_om_t *                     om,
+         const my_om_metric_t *        metric,
+         const char *                  key );
+
+
+static int
+my_fmt_om_footer(
+         my_config_t *                 cnf );
+
+
+static void
+my_fmt_om_free(
+         my_om_t *                     om );
+
+
+static int
+my_fmt_om_key_value(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val );
+
+
+static int
+my_fmt_om_label(
+         my_buffer_t *                 buff,
+         const char *                  data,
+         size_t                        len );
+
+
+static int
+my_fmt_om_list_item(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const my_value_t *            val );
+
+
+static int
+my_fmt_om_list_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key );
+
+
+static int
+my_fmt_om_match(
+         my_config_t *                 cnf,
+         my_om_t *                     om,
+         const char *                  key,
+         int                           prefix );
+
+
+static int
+my_fmt_om_msg_start(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_om_put(
+         my_buffer_t *                 buff,
+         const char *                  data,
+         size_t                        len );
+
+
+static int
+my_fmt_om_record(
+         my_om_t *                     om,
+         const char *                  label,
+         const char *                  data,
+         size_t                        len );
+
+
+static int
+my_fmt_om_sample(
+         my_config_t *                 cnf,
+         my_om_t *                     om,
+         const char *                  key,
+         const my_value_t *            val );
+
+
+static int
+my_fmt_om_sect_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key );
+
+
+static const char *
+my_fmt_om_segment(
+         my_config_t *                 cnf,
+         size_t                        pos,
+         const char *                  key );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+// MARK: - Variables
+
+#pragma mark my_emitter_openmetrics
+const my_emitter_t my_emitter_openmetrics =
+{  .format           = MY_FMT_OPENMETRICS,
+   .flags            = MY_EMIT_ROWS,
+   .func_footer      = &my_fmt_om_footer,
+   .func_key_value   = &my_fmt_om_key_value,
+   .func_list_end    = NULL,
+   .func_list_item   = &my_fmt_om_list_item,
+   .func_list_start  = &my_fmt_om_list_start,
+   .func_msg_end     = NULL,
+   .func_msg_start   = &my_fmt_om_msg_start,
+   .func_sect_end    = NULL,
+   .func_sect_start  = &my_fmt_om_sect_start,
+};
+
+
+// elements are mapped by the first matching path, each `*' in the path and
+// the value of info metrics provide the next label, families without a name
+// are named after the element. For widgets returning records, an entry
+// without a path names the label of the record and entries without a type
+// add the value of the element to the labels of the record.
+#pragma mark my_om_metrics[]
+static const my_om_metric_t my_om_metrics[] =
+{  // stats reply
+   { "stats",         "workers.total",                     "strongswan_workers",                     "gauge",    NULL,           "Number of worker threads." },
+   { "stats",         "workers.idle",                      "strongswan_workers_idle",                "gauge",    NULL,           "Number of idle worker threads." },
+   { "stats",         "workers.active.*",                  "strongswan_workers_active",              "gauge",    "priority",     "Number of worker threads processing jobs by priority." },
+   { "stats",         "queues.*",                          "strongswan_queued_jobs",                 "gauge",    "priority",     "Number of queued jobs by priority." },
+   { "stats",         "scheduled",                         "strongswan_scheduled_jobs",              "gauge",    NULL,           "Number of scheduled jobs." },
+   { "stats",         "ikesas.total",                      "strongswan_ikesas",                      "gauge",    NULL,           "Number of IKE_SAs." },
+   { "stats",         "ikesas.half-open",                  "strongswan_ikesas_half_open",            "gauge",    NULL,           "Number of half-open IKE_SAs." },
+   { "stats",         "plugins",                           "strongswan_plugin",                      "info",     "plugin",       "Loaded plugins." },
+   { "stats",         "mem.total",                         "strongswan_mem_bytes",                   "gauge",    NULL,           "Allocated memory in bytes." },
+   { "stats",         "mem.allocs",                        "strongswan_mem_allocs",                  "gauge",    NULL,           "Number of memory allocations." },
+   { "stats",         "mem.*.total",                       "strongswan_mem_heap_bytes",              "gauge",    "heap",         "Allocated memory of heap in bytes." },
+   { "stats",         "mem.*.allocs",                      "strongswan_mem_heap_allocs",             "gauge",    "heap",         "Number of memory allocations of heap." },
+   { "stats",         "mallinfo.*",                        "strongswan_mallinfo_bytes",              "gauge",    "type",         "Memory usage reported by mallinfo in bytes." },
+
+   // get-counters reply
+   { "get-counters",  "counters.*.ike-rekey-init",         NULL,                                     "counter",  "conn",         "IKE_SA rekeyings initiated." },
+   { "get-counters",  "counters.*.ike-rekey-resp",         NULL,                                     "counter",  "conn",         "IKE_SA rekeyings responded to." },
+   { "get-counters",  "counters.*.child-rekey",            NULL,                                     "counter",  "conn",         "CHILD_SA rekeyings." },
+   { "get-counters",  "counters.*.invalid",                NULL,                                     "counter",  "conn",         "Messages with an invalid type, length or value." },
+   { "get-counters",  "counters.*.invalid-spi",            NULL,                                     "counter",  "conn",         "Messages with an invalid IKE SPI." },
+   { "get-counters",  "counters.*.ike-init-in-req",        NULL,                                     "counter",  "conn",         "IKE_SA_INIT requests received." },
+   { "get-counters",  "counters.*.ike-init-in-resp",       NULL,                                     "counter",  "conn",         "IKE_SA_INIT responses received." },
+   { "get-counters",  "counters.*.ike-init-out-req",       NULL,                                     "counter",  "conn",         "IKE_SA_INIT requests sent." },
+   { "get-counters",  "counters.*.ike-init-out-resp",      NULL,                                     "counter",  "conn",         "IKE_SA_INIT responses sent." },
+   { "get-counters",  "counters.*.ike-auth-in-req",        NULL,                                     "counter",  "conn",         "IKE_AUTH requests received." },
+   { "get-counters",  "counters.*.ike-auth-in-resp",       NULL,                                     "counter",  "conn",         "IKE_AUTH responses received." },
+   { "get-counters",  "counters.*.ike-auth-out-req",       NULL,                                     "counter",  "conn",         "IKE_AUTH requests sent." },
+   { "get-counters",  "counters.*.ike-auth-out-resp",      NULL,                                     "counter",  "conn",         "IKE_AUTH responses sent." },
+   { "get-counters",  "counters.*.create-child-in-req",    NULL,                                     "counter",  "conn",         "CREATE_CHILD_SA requests received." },
+   { "get-counters",  "counters.*.create-child-in-resp",   NULL,                                     "counter",  "conn",         "CREATE_CHILD_SA responses received." },
+   { "get-counters",  "counters.*.create-child-out-req",   NULL,                                     "counter",  "conn",         "CREATE_CHILD_SA requests sent." },
+   { "get-counters",  "counters.*.create-child-out-resp",  NULL,                                     "counter",  "conn",         "CREATE_CHILD_SA responses sent." },
+   { "get-counters",  "counters.*.info-in-req",            NULL,                                     "counter",  "conn",         "INFORMATIONAL requests received." },
+   { "get-counters",  "counters.*.info-in-resp",           NULL,                                     "counter",  "conn",         "INFORMATIONAL responses received." },
+   { "get-counters",  "counters.*.info-out-req",           NULL,                                     "counter",  "conn",         "INFORMATIONAL requests sent." },
+   { "get-counters",  "counters.*.info-out-resp",          NULL,                                     "counter",  "conn",         "INFORMATIONAL responses sent." },
+   { "get-counters",  "counters.*.*",                      NULL,                                     "counter",  "conn",         "Counter of connection reported by the daemon." },
+
+   // list-sa events
+   { "list-sa",       NULL,                                NULL,                                     NULL,       "ike",          NULL },
+   { "list-sa",       "uniqueid",                          NULL,                                     NULL,       "ike_id",       NULL },
+   { "list-sa",       "state",                             "strongswan_ike_sa_state",                "info",     "state",        "State of IKE_SA." },
+   { "list-sa",       "established",                       "strongswan_ike_sa_established_seconds",  "gauge",    NULL,           "Seconds since IKE_SA was established." },
+   { "list-sa",       "child-sas.*.state",                 "strongswan_child_sa_state",              "info",     "child,state",  "State of CHILD_SA." },
+   { "list-sa",       "child-sas.*.bytes-in",              "strongswan_child_sa_bytes_in",           "counter",  "child",        "Bytes received by CHILD_SA." },
+   { "list-sa",       "child-sas.*.bytes-out",             "strongswan_child_sa_bytes_out",          "counter",  "child",        "Bytes sent by CHILD_SA." },
+   { "list-sa",       "child-sas.*.packets-in",            "strongswan_child_sa_packets_in",         "counter",  "child",        "Packets received by CHILD_SA." },
+   { "list-sa",       "child-sas.*.packets-out",           "strongswan_child_sa_packets_out",        "counter",  "child",        "Packets sent by CHILD_SA." },
+
+   // list-sas reply
+   { "list-sas",      NULL,                                NULL,                                     NULL,       NULL,           NULL },
+   { NULL,            NULL,                                NULL,                                     NULL,       NULL,           NULL }
+};
+static const size_t my_om_nmetrics = (sizeof(my_om_metrics) / sizeof(my_om_metric_t)) - 1;
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+my_om_family_t *
+my_fmt_om_family(
+         my_om_t *                     om,
+         const my_om_metric_t *        metric,
+         const char *                  key )
+{
+   size_t            pos;
+   size_t            off;
+   void *            ptr;
+   my_om_family_t *  family;
+
+   // families without a name are named after the element
+   om->name.len = 0;
+   if ((metric->name))
+   {  if (my_fmt_om_put(&om->name, metric->name, strlen(metric->name)) < 0)
+         return(NULL);
+   } else
+   {  if (my_fmt_om_put(&om->name, "strongswan_", 11) < 0)
+         return(NULL);
+      off = om->name.len;
+      if (my_fmt_om_put(&om->name, key, strlen(key)) < 0)
+         return(NULL);
+      for(pos = off; (pos < om->name.len); pos++)
+         if (strchr("abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789_:", om->name.data[pos]) == NULL)
+            om->name.data[pos] = '_';
+   };
+   if (my_fmt_om_put(&om->name, "", 1) < 0)
+      return(NULL);
+
+   for(pos = 0; (pos < om->nfamilies); pos++)
+      if (!(strcmp(om->families[pos].name, om->name.data)))
+         return(&om->families[pos]);
+
+   if ((ptr = realloc(om->families, sizeof(my_om_family_t) * (om->nfamilies + 1))) == NULL)
+      return(NULL);
+   om->families   = ptr;
+   family         = &om->families[om->nfamilies];
+   memset(family, 0, sizeof(my_om_family_t));
+   if ((family->name = strdup(om->name.data)) == NULL)
+      return(NULL);
+   family->metric = metric;
+   om->nfamilies++;
+
+   return(family);
+}
+
+
+int
+my_fmt_om_footer(
+         my_config_t *                 cnf )
+{
+   int               rc;
+   size_t            pos;
+   my_om_t *         om;
+   my_om_family_t *  family;
+
+   // replies which did not satisfy the where predicates
+   if ((om = cnf->emitter_state) == NULL)
+      return(my_out_puts(cnf, "# EOF\n"));
+
+   // samples of a family are written together
+   rc = 0;
+   for(pos = 0; ((rc == 0) && (pos < om->nfamilies)); pos++)
+   {  family = &om->families[pos];
+      if ((rc = my_out_printf(cnf, "# TYPE %s %s\n", family->name, family->metric->type)) < 0)
+         break;
+      if ((rc = my_out_printf(cnf, "# HELP %s %s\n", family->name, family->metric->help)) < 0)
+         break;
+      rc = my_out_write(cnf, family->samples.data, family->samples.len);
+   };
+   if (rc == 0)
+      rc = my_out_puts(cnf, "# EOF\n");
+
+   my_fmt_om_free(om);
+   cnf->emitter_state = NULL;
+
+   return(rc);
+}
+
+
+void
+my_fmt_om_free(
+         my_om_t *                     om )
+{
+   size_t            pos;
+
+   if (!(om))
+      return;
+
+   if ((om->paths))
+      for(pos = 0; (pos < my_om_nmetrics); pos++)
+         my_parse_path_free(&om->paths[pos]);
+   free(om->paths);
+   for(pos = 0; (pos < om->nfamilies); pos++)
+   {  free(om->families[pos].name);
+      my_buffer_free(&om->families[pos].samples);
+   };
+   free(om->families);
+   my_buffer_free(&om->name);
+   my_buffer_free(&om->record);
+   free(om);
+
+   return;
+}
+
+
+int
+my_fmt_om_key_value(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val )
+{
+   (void)level;
+   return(my_fmt_om_sample(cnf, cnf->emitter_state, key, val));
+}
+
+
+int
+my_fmt_om_label(
+         my_buffer_t *                 buff,
+         const char *                  data,
+         size_t                        len )
+{
+   int               rc;
+   size_t            pos;
+
+   for(pos = 0; (pos < len); pos++)
+   {  switch(data[pos])
+      {  case '\\': rc = my_fmt_om_put(buff, "\\\\", 2); break;
+         case '"':  rc = my_fmt_om_put(buff, "\\\"", 2); break;
+         case '\n': rc = my_fmt_om_put(buff, "\\n",  2); break;
+         default:   rc = my_fmt_om_put(buff, &data[pos], 1); break;
+      };
+      if (rc < 0)
+         return(rc);
+   };
+
+   return(0);
+}
+
+
+int
+my_fmt_om_list_item(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const my_value_t *            val )
+{
+   (void)level;
+   return(my_fmt_om_sample(cnf, cnf->emitter_state, NULL, val));
+}
+
+
+int
+my_fmt_om_list_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key )
+{
+   my_om_t *         om;
+
+   (void)level;
+   (void)key;
+
+   om = cnf->emitter_state;
+
+   // skip lists which are not mapped
+   return((my_fmt_om_match(cnf, om, NULL, 0) < 0) ? MY_EMIT_SKIP : 0);
+}
+
+
+int
+my_fmt_om_match(
+         my_config_t *                 cnf,
+         my_om_t *                     om,
+         const char *                  key,
+         int                           prefix )
+{
+   size_t            pos;
+
+   for(pos = om->first; (pos < om->last); pos++)
+   {  if (!(my_om_metrics[pos].path))
+         continue;
+      if ((my_parse_path_match(cnf, &om->paths[pos], key, prefix)))
+         return((int)pos);
+   };
+
+   return(-1);
+}
+
+
+int
+my_fmt_om_msg_start(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event )
+{
+   int               rc;
+   size_t            pos;
+   size_t            metric;
+   my_om_t *         om;
+
+   (void)is_event;
+
+   // metrics are mapped by name of message
+   for(metric = 0; (metric < my_om_nmetrics); metric++)
+      if (!(strcasecmp(name, my_om_metrics[metric].msg)))
+         break;
+   if (metric == my_om_nmetrics)
+   {  fprintf(stderr, "%s: openmetrics output is only supported by get-counters, list-sas and stats\n", my_prog_name(cnf));
+      return(-ENOTSUP);
+   };
+
+   if ((om = cnf->emitter_state) == NULL)
+   {  if ((om = calloc(1, sizeof(my_om_t))) == NULL)
+         return(-ENOMEM);
+      cnf->emitter_state = om;
+      if ((om->paths = calloc(my_om_nmetrics, sizeof(my_path_t))) == NULL)
+         return(-ENOMEM);
+      for(pos = 0; (pos < my_om_nmetrics); pos++)
+         if ((my_om_metrics[pos].path))
+            if ((rc = my_parse_path_compile(&om->paths[pos], my_om_metrics[pos].path)) < 0)
+               return(rc);
+   };
+
+   // entries of a message are adjacent within the table
+   om->first      = metric;
+   for(om->last = metric; (om->last < my_om_nmetrics); om->last++)
+      if ((strcasecmp(name, my_om_metrics[om->last].msg)))
+         break;
+   om->records    = (((cnf->flags | cnf->widget->flags) & MY_FLG_RECORDS)) ? 1 : 0;
+   om->record.len = 0;
+
+   return(0);
+}
+
+
+int
+my_fmt_om_put(
+         my_buffer_t *                 buff,
+         const char *                  data,
+         size_t                        len )
+{
+   char *            ptr;
+
+   if ((ptr = my_buffer_alloc(buff, len)) == NULL)
+      return(-ENOMEM);
+   if ((len))
+      memcpy(ptr, data, len);
+
+   return(0);
+}
+
+
+int
+my_fmt_om_record(
+         my_om_t *                     om,
+         const char *                  label,
+         const char *                  data,
+         size_t                        len )
+{
+   int               rc;
+
+   if ( (!(label)) || (!(len)) )
+      return(0);
+
+   if ((om->record.len))
+      if ((rc = my_fmt_om_put(&om->record, ",", 1)) < 0)
+         return(rc);
+   if ((rc = my_fmt_om_put(&om->record, label, strlen(label))) < 0)
+      return(rc);
+   if ((rc = my_fmt_om_put(&om->record, "=\"", 2)) < 0)
+      return(rc);
+   if ((rc = my_fmt_om_label(&om->record, data, len)) < 0)
+      return(rc);
+
+   return(my_fmt_om_put(&om->record, "\"", 1));
+}
+
+
+int
+my_fmt_om_sample(
+         my_config_t *                 cnf,
+         my_om_t *                     om,
+         const char *                  key,
+         const my_value_t *            val )
+{
+   int                     rc;
+   int                     metric;
+   int                     is_info;
+   size_t                  pos;
+   size_t                  len;
+   size_t                  labels;
+   char *                  end;
+   char                    num[MY_OM_NUM_MAX];
+   const char *            names;
+   const char *            data;
+   const char *            suffix;
+   const my_path_t *       path;
+   my_om_family_t *        family;
+   my_buffer_t *           buff;
+
+   if ((metric = my_fmt_om_match(cnf, om, key, 0)) < 0)
+      return(0);
+   path = &om->paths[metric];
+
+   if ((val->is_binary))
+      return(0);
+
+   // element provides a label of the samples of its record
+   if (!(my_om_metrics[metric].type))
+      return(my_fmt_om_record(om, my_om_metrics[metric].labels, val->data, val->len));
+
+   // info metrics report their labels, other samples must be numeric
+   if ((is_info = (!(strcmp(my_om_metrics[metric].type, "info"))) ? 1 : 0))
+   {  suffix = "_info";
+      strcpy(num, "1");
+   } else
+   {  if ( (!(val->len)) || (val->len >= sizeof(num)) )
+         return(0);
+      memcpy(num, val->data, val->len);
+      num[val->len] = '\0';
+      strtod(num, &end);
+      if (end[0] != '\0')
+         return(0);
+      suffix = (!(strcmp(my_om_metrics[metric].type, "counter"))) ? "_total" : "";
+   };
+
+   if ((family = my_fmt_om_family(om, &my_om_metrics[metric], key)) == NULL)
+      return(-ENOMEM);
+   buff = &family->samples;
+
+   // name{label="value",...} number
+   if ((rc = my_fmt_om_put(buff, family->name, strlen(family->name))) < 0)
+      return(rc);
+   if ((rc = my_fmt_om_put(buff, suffix, strlen(suffix))) < 0)
+      return(rc);
+   labels = 0;
+   if ((om->record.len))
+   {  if ((rc = my_fmt_om_put(buff, "{", 1)) < 0)
+         return(rc);
+      if ((rc = my_fmt_om_put(buff, om->record.data, om->record.len)) < 0)
+         return(rc);
+      labels++;
+   };
+   names = my_om_metrics[metric].labels;
+   for(pos = 0; ( ((names)) && ((names[0])) && (pos <= path->nsegs) ); pos++)
+   {  // wildcard segments are followed by the value of info metrics
+      if (pos < path->nsegs)
+      {  if (strcmp(path->segs[pos], "*"))
+            continue;
+         data  = my_fmt_om_segment(cnf, pos, key);
+         len   = strlen(data);
+      } else
+      {  if (!(is_info))
+            break;
+         data  = val->data;
+         len   = val->len;
+      };
+      if ((len))
+      {  if ((rc = my_fmt_om_put(buff, ((labels)) ? "," : "{", 1)) < 0)
+            return(rc);
+         if ((rc = my_fmt_om_put(buff, names, strcspn(names, ","))) < 0)
+            return(rc);
+         if ((rc = my_fmt_om_put(buff, "=\"", 2)) < 0)
+            return(rc);
+         if ((rc = my_fmt_om_label(buff, data, len)) < 0)
+            return(rc);
+         if ((rc = my_fmt_om_put(buff, "\"", 1)) < 0)
+            return(rc);
+         labels++;
+      };
+      names = &names[strcspn(names, ",")];
+      names = (names[0] == ',') ? &names[1] : names;
+   };
+   if ((labels))
+      if ((rc = my_fmt_om_put(buff, "}", 1)) < 0)
+         return(rc);
+   if ((rc = my_fmt_om_put(buff, " ", 1)) < 0)
+      return(rc);
+   if ((rc = my_fmt_om_put(buff, num, strlen(num))) < 0)
+      return(rc);
+
+   return(my_fmt_om_put(buff, "\n", 1));
+}
+
+
+int
+my_fmt_om_sect_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key )
+{
+   int               rc;
+   size_t            pos;
+   my_om_t *         om;
+
+   om = cnf->emitter_state;
+
+   // name of record is the first label of its samples, records received
+   // from multiple sockets are labeled with the path of the socket
+   if ( ((om->records)) && (level == 1) )
+   {  om->record.len = 0;
+      if ((cnf->sock))
+         if ((rc = my_fmt_om_record(om, "socket", cnf->sock->path, strlen(cnf->sock->path))) < 0)
+            return(rc);
+      for(pos = om->first; (pos < om->last); pos++)
+         if (!(my_om_metrics[pos].path))
+            return(my_fmt_om_record(om, my_om_metrics[pos].labels, key, strlen(key)));
+      return(0);
+   };
+
+   // skip subtrees which do not contain a mapped element
+   return((my_fmt_om_match(cnf, om, NULL, 1) < 0) ? MY_EMIT_SKIP : 0);
+}
+
+
+const char *
+my_fmt_om_segment(
+         my_config_t *                 cnf,
+         size_t                        pos,
+         const char *                  key )
+{
+   size_t            off;
+
+   if ( ((key)) && (pos == (cnf->path_offs.len / sizeof(size_t))) )
+      return(key);
+   memcpy(&off, &cnf->path_offs.data[pos * sizeof(size_t)], sizeof(size_t));
+
+   return(&cnf->path.data[off]);
+}
+
+
+/* end of source */
@@ -0,0 +1,406 @@
+/*
+ *  Davici Utilities for Strongswan
+ *  Copyright (C) 2026 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __SRC_FORMAT_XML_C 1
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include "davicictl.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+
+#include <davici.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+
+//////////////
+//          //
+//  Macros  //
+//          //
+//////////////
+// MARK: - Macros
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+#pragma mark - Datatypes
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static int
+my_fmt_xml_delim(
+         my_config_t *                 cnf,
+         unsigned                      level );
+
+
+static int
+my_fmt_xml_footer(
+         my_config_t *                 cnf );
+
+
+static int
+my_fmt_xml_key_value(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val );
+
+
+static int
+my_fmt_xml_list_end(
+         my_config_t *                 cnf,
+         unsigned                      level );
+
+
+static int
+my_fmt_xml_list_item(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const my_value_t *            val );
+
+
+static int
+my_fmt_xml_list_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key );
+
+
+static int
+my_fmt_xml_msg_end(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_xml_msg_start(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_xml_name(
+         my_config_t *                 cnf,
+         const char *                  open,
+         const char *                  name,
+         int                           is_event );
+
+
+static int
+my_fmt_xml_sect_end(
+         my_config_t *                 cnf,
+         unsigned                      level );
+
+
+static const char *
+my_fmt_xml_sect_pop(
+         my_config_t *                 cnf );
+
+
+static int
+my_fmt_xml_sect_push(
+         my_config_t *                 cnf,
+         const char *                  sect );
+
+
+static int
+my_fmt_xml_sect_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key );
+
+
+static int
+my_fmt_xml_tag(
+         my_config_t *                 cnf,
+         const char *                  open,
+         const char *                  tag );
+
+
+/////////////////
+//             //
+//  Variables  //
+//             //
+/////////////////
+// MARK: - Variables
+
+#pragma mark my_emitter_xml
+const my_emitter_t my_emitter_xml =
+{  .format           = MY_FMT_XML,
+   .flags            = 0,
+   .func_footer      = &my_fmt_xml_footer,
+   .func_key_value   = &my_fmt_xml_key_value,
+   .func_list_end    = &my_fmt_xml_list_end,
+   .func_list_item   = &my_fmt_xml_list_item,
+   .func_list_start  = &my_fmt_xml_list_start,
+   .func_msg_end     = &my_fmt_xml_msg_end,
+   .func_msg_start   = &my_fmt_xml_msg_start,
+   .func_sect_end    = &my_fmt_xml_sect_end,
+   .func_sect_start  = &my_fmt_xml_sect_start,
+};
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+my_fmt_xml_delim(
+         my_config_t *                 cnf,
+         unsigned                      level )
+{
+   level++;
+   if (!(cnf->flags & MY_FLG_PRETTY))
+      return(0);
+   return(my_out_delim(cnf, MY_OUT_DELIM_NEWLINE, level));
+}
+
+
+int
+my_fmt_xml_footer(
+         my_config_t *                 cnf )
+{
+   // replies which did not satisfy the where predicates
+   if (!(cnf->res_last_id))
+      return(my_out_puts(cnf, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<vici></vici>\n"));
+   return(my_out_puts(cnf, ((cnf->flags & MY_FLG_PRETTY)) ? "\n</vici>\n" : "</vici>\n"));
+}
+
+
+int
+my_fmt_xml_key_value(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key,
+         const my_value_t *            val )
+{
+   my_fmt_xml_delim(cnf, level);
+   my_fmt_xml_tag(cnf, "<", key);
+   my_out_xml_value(cnf, val);
+   return(my_fmt_xml_tag(cnf, "</", key));
+}
+
+
+int
+my_fmt_xml_list_end(
+         my_config_t *                 cnf,
+         unsigned                      level )
+{
+   my_fmt_xml_delim(cnf, level);
+   return(my_fmt_xml_tag(cnf, "</", my_fmt_xml_sect_pop(cnf)));
+}
+
+
+int
+my_fmt_xml_list_item(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const my_value_t *            val )
+{
+   my_fmt_xml_delim(cnf, level);
+   my_out_write(cnf, "<item>", 6);
+   my_out_xml_value(cnf, val);
+   return(my_out_write(cnf, "</item>", 7));
+}
+
+
+int
+my_fmt_xml_list_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key )
+{
+   int               rc;
+
+   if ((rc = my_fmt_xml_sect_push(cnf, key)) != 0)
+      return(rc);
+   my_fmt_xml_delim(cnf, level);
+   return(my_fmt_xml_tag(cnf, "<", key));
+}
+
+
+int
+my_fmt_xml_msg_end(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  name,
+         int                           is_event )
+{
+   my_fmt_xml_delim(cnf, level);
+   cnf->sects.len       = 0;
+   cnf->sects_offs.len  = 0;
+   return(my_fmt_xml_name(cnf, "</", name, is_event));
+}
+
+
+int
+my_fmt_xml_msg_start(
+         my_config_t *                 cnf,
+         const char *                  name,
+         int                           is_event )
+{
+   // print XML header
+   if (!(cnf->res_last_id))
+      my_out_puts(cnf, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<vici>");
+
+   // print event/command section start
+   cnf->sects.len       = 0;
+   cnf->sects_offs.len  = 0;
+   my_fmt_xml_delim(cnf, 0);
+   return(my_fmt_xml_name(cnf, "<", name, is_event));
+}
+
+
+int
+my_fmt_xml_name(
+         my_config_t *                 cnf,
+         const char *                  open,
+         const char *                  name,
+         int                           is_event )
+{
+   my_out_puts(cnf, open);
+   my_out_puts(cnf, name);
+   return(my_out_puts(cnf, (((is_event)) ? "-event>" : "-reply>")));
+}
+
+
+int
+my_fmt_xml_sect_end(
+         my_config_t *                 cnf,
+         unsigned                      level )
+{
+   my_fmt_xml_delim(cnf, level);
+   return(my_fmt_xml_tag(cnf, "</", my_fmt_xml_sect_pop(cnf)));
+}
+
+
+const char *
+my_fmt_xml_sect_pop(
+         my_config_t *                 cnf )
+{
+   size_t            off;
+
+   assert(cnf->sects_offs.len >= sizeof(size_t));
+
+   // name remains in buffer until the next section is pushed
+   cnf->sects_offs.len -= sizeof(size_t);
+   memcpy(&off, &cnf->sects_offs.data[cnf->sects_offs.len], sizeof(size_t));
+   cnf->sects.len = off;
+
+   return(&cnf->sects.data[off]);
+}
+
+
+int
+my_fmt_xml_sect_push(
+         my_config_t *                 cnf,
+         const char *                  sect )
+{
+   size_t            len;
+   size_t            off;
+   char *            ptr;
+
+   // names are stored NUL terminated along with their offsets
+   off = cnf->sects.len;
+   len = strlen(sect) + 1;
+   if ((ptr = my_buffer_alloc(&cnf->sects, len)) == NULL)
+      return(-ENOMEM);
+   memcpy(ptr, sect, len);
+   if ((ptr = my_buffer_alloc(&cnf->sects_offs, sizeof(size_t))) == NULL)
+      return(-ENOMEM);
+   memcpy(ptr, &off, sizeof(size_t));
+
+   return(0);
+}
+
+
+int
+my_fmt_xml_sect_start(
+         my_config_t *                 cnf,
+         unsigned                      level,
+         const char *                  key )
+{
+   int               rc;
+
+   if ((rc = my_fmt_xml_sect_push(cnf, key)) != 0)
+      return(rc);
+   my_fmt_xml_delim(cnf, level);
+   return(my_fmt_xml_tag(cnf, "<", key));
+}
+
+
+int
+my_fmt_xml_tag(
+         my_config_t *                 cnf,
+         const char *                  open,
+         const char *                  tag )
+{
+   my_out_puts(cnf, open);
+   my_out_puts(cnf, tag);
+   return(my_out_putc(cnf, '>'));
+}
+
+
+/* end of source */
@@ -0,0 +1,603 @@
+/*
+ *  Davici Utilities for Strongswan
+ *  Copyright (C) 2026 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __SRC_WIDGET_BATCH_C 1
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include "davicictl.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <poll.h>
+
+#include <davici.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#define MY_BATCH_WINDOW          32
+#define MY_BATCH_ARGS            16
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+// MARK: - Datatypes
+
+typedef struct _my_batch_cmd     my_batch_cmd_t;
+
+
+struct _my_batch_cmd
+{  my_config_t *                 cnf;
+   size_t                        line;
+   char *                        args;
+   char **                       argv;
+   my_buffer_t                   out;
+};
+
+
+struct _my_batch
+{  FILE *                        fp;
+   const char *                  path;
+   int                           eof;
+   int                           failed;
+   size_t                        line;
+   size_t                        window;
+   size_t                        head;
+   size_t                        len;
+   my_buffer_t                   input;
+   my_batch_cmd_t *              cmds;
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static int
+my_widget_batch_emit(
+         my_config_t *                 cnf,
+         my_batch_t *                  batch );
+
+
+static void
+my_widget_batch_free(
+         my_batch_t *                  batch );
+
+
+static void
+my_widget_batch_free_cmd(
+         my_batch_cmd_t *              cmd );
+
+
+static int
+my_widget_batch_poll(
+         my_config_t *                 cnf );
+
+
+static int
+my_widget_batch_queue(
+         my_config_t *                 cnf,
+         my_batch_t *                  batch );
+
+
+static int
+my_widget_batch_read(
+         my_config_t *                 cnf,
+         my_batch_t *                  batch );
+
+
+static int
+my_widget_batch_split(
+         my_batch_cmd_t *              cmd );
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+my_widget_batch(
+         my_config_t *                 cnf )
+{
+   int                     rc;
+   my_batch_t *            batch;
+
+   if (!(cnf))
+      return(1);
+
+   // commands share the connection and polling loop of a single socket
+   if ((cnf->sock))
+   {  fprintf(stderr, "%s: multiple vici sockets are not supported\n", my_prog_name(cnf));
+      return(1);
+   };
+   if ((cnf->opt_deadline))
+   {  fprintf(stderr, "%s: deadline is not supported\n", my_prog_name(cnf));
+      return(1);
+   };
+
+   if ((batch = calloc(1, sizeof(my_batch_t))) == NULL)
+   {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      return(1);
+   };
+   batch->window  = ((cnf->opt_window)) ? cnf->opt_window : MY_BATCH_WINDOW;
+   batch->path    = ((cnf->argc)) ? cnf->argv[0] : "-";
+   cnf->batch     = batch;
+
+   if ((batch->cmds = calloc(batch->window, sizeof(my_batch_cmd_t))) == NULL)
+   {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      my_widget_batch_free(batch);
+      return(1);
+   };
+
+   // read commands from file or standard input
+   if (!(strcmp(batch->path, "-")))
+   {  batch->fp   = stdin;
+      batch->path = "(stdin)";
+   } else if ((batch->fp = fopen(batch->path, "r")) == NULL)
+   {  fprintf(stderr, "%s: %s: %s\n", my_prog_name(cnf), batch->path, strerror(errno));
+      my_widget_batch_free(batch);
+      return(1);
+   };
+
+   // commands are queued on the connection while fewer than the window
+   // of commands await responses, and the output of each command is
+   // written in the order the commands were read once it has completed
+   rc = 0;
+   my_verbose(cnf, "entering polling loop ...\n");
+   while ( (!(my_should_exit)) && (!(rc)) )
+   {  if ((rc = my_widget_batch_emit(cnf, batch)))
+         break;
+
+      // commands following an invalid command are not read, however
+      // commands preceding it have been queued and are completed
+      while ( (!(batch->eof)) && (batch->len < batch->window) )
+      {  if ((my_widget_batch_queue(cnf, batch)))
+         {  batch->eof     = 1;
+            batch->failed  = 1;
+         };
+      };
+      if ( ((batch->eof)) && (!(batch->len)) )
+         break;
+
+      rc = my_widget_batch_poll(cnf);
+   };
+
+   // output of commands which completed before an error or signal is
+   // written, commands still awaiting responses are abandoned
+   if ((my_widget_batch_emit(cnf, batch)))
+      rc = 1;
+   if ((batch->len))
+      my_verbose(cnf, "abandoning %zu batched commands ...\n", batch->len);
+   if ((batch->failed))
+      rc = 1;
+
+   my_widget_batch_free(batch);
+   cnf->batch = NULL;
+
+   return( ( ((rc)) || (my_should_exit < 0) ) ? 1 : 0);
+}
+
+
+int
+my_widget_batch_emit(
+         my_config_t *                 cnf,
+         my_batch_t *                  batch )
+{
+   int                     rc;
+   size_t                  pos;
+   my_batch_cmd_t *        cmd;
+   my_config_t *           ccnf;
+   my_stats_t *            stats;
+
+   stats = &cnf->stats;
+
+   while ((batch->len))
+   {  cmd  = &batch->cmds[batch->head];
+      ccnf = cmd->cnf;
+      if (ccnf->queued > 0)
+         break;
+
+      // complete document of command and append it to output
+      rc = my_parse_footer(ccnf);
+      if (rc >= 0)
+         rc = my_out_flush(ccnf);
+      if (rc >= 0)
+         rc = my_out_write(cnf, cmd->out.data, cmd->out.len);
+
+      // account messages formatted by the command
+      stats->messages      += ccnf->stats.messages;
+      stats->replies       += ccnf->stats.replies;
+      stats->format_total  += ccnf->stats.format_total;
+      stats->reply_total   += ccnf->stats.reply_total;
+      stats->format_max     = (ccnf->stats.format_max > stats->format_max) ? ccnf->stats.format_max : stats->format_max;
+      stats->reply_max      = (ccnf->stats.reply_max  > stats->reply_max)  ? ccnf->stats.reply_max  : stats->reply_max;
+
+      my_widget_batch_free_cmd(cmd);
+      batch->head = (batch->head + 1) % batch->window;
+      batch->len--;
+
+      if (rc < 0)
+         return(1);
+   };
+
+   // requests of remaining commands are outstanding
+   cnf->queued = 0;
+   for(pos = 0; (pos < batch->len); pos++)
+      cnf->queued += batch->cmds[(batch->head + pos) % batch->window].cnf->queued;
+
+   return(0);
+}
+
+
+void
+my_widget_batch_free(
+         my_batch_t *                  batch )
+{
+   size_t            pos;
+
+   if (!(batch))
+      return;
+
+   if ((batch->cmds))
+   {  for(pos = 0; (pos < batch->len); pos++)
+         my_widget_batch_free_cmd(&batch->cmds[(batch->head + pos) % batch->window]);
+      free(batch->cmds);
+   };
+   if ( ((batch->fp)) && (batch->fp != stdin) )
+      fclose(batch->fp);
+   my_buffer_free(&batch->input);
+   free(batch);
+
+   return;
+}
+
+
+void
+my_widget_batch_free_cmd(
+         my_batch_cmd_t *              cmd )
+{
+   my_config_t *     ccnf;
+
+   if ((ccnf = cmd->cnf) != NULL)
+   {  my_parse_free(ccnf);
+      free(ccnf->out.data);
+      my_buffer_free(&ccnf->msg_buff);
+      my_buffer_free(&ccnf->msg_stack);
+      my_buffer_free(&ccnf->sects);
+      my_buffer_free(&ccnf->sects_offs);
+      free(ccnf);
+   };
+   my_buffer_free(&cmd->out);
+   free(cmd->args);
+   free(cmd->argv);
+   memset(cmd, 0, sizeof(my_batch_cmd_t));
+
+   return;
+}
+
+
+int
+my_widget_batch_poll(
+         my_config_t *                 cnf )
+{
+   int               rc;
+   struct pollfd     pfds[2];
+
+   // write output of completed commands before waiting for more data
+   if ((my_out_flush(cnf)))
+      return(1);
+   if (cnf->pollfd.fd == -1)
+   {  fprintf(stderr, "%s: connection to vici socket closed\n", my_prog_name(cnf));
+      return(1);
+   };
+
+   pfds[0]           = cnf->pollfd;
+   pfds[1].fd        = cnf->signal_fd;
+   pfds[1].events    = POLLIN;
+   pfds[1].revents   = 0;
+   if ((rc = poll(pfds, 2, 30000)) < 0)
+   {  if (errno == EINTR)
+         return(0);
+      fprintf(stderr, "%s: poll(): %s\n", my_prog_name(cnf), strerror(errno));
+      return(1);
+   };
+   if ((pfds[1].revents & POLLIN))
+      my_signal(cnf);
+   if ((pfds[0].revents & POLLIN))
+   {  my_verbose(cnf, "reading data from vici socket ...\n");
+      if ((rc = davici_read(cnf->davici_conn)) < 0)
+      {  fprintf(stderr, "%s: davici_read(): %s\n", my_prog_name(cnf), strerror(-rc));
+         return(1);
+      };
+   };
+   if ((pfds[0].revents & POLLOUT))
+   {  my_verbose(cnf, "writing data to vici socket ...\n");
+      if ((rc = davici_write(cnf->davici_conn)) < 0)
+      {  fprintf(stderr, "%s: davici_write(): %s\n", my_prog_name(cnf), strerror(-rc));
+         return(1);
+      };
+   };
+
+   return(0);
+}
+
+
+int
+my_widget_batch_queue(
+         my_config_t *                 cnf,
+         my_batch_t *                  batch )
+{
+   int                     rc;
+   int                     argc;
+   size_t                  pos;
+   my_batch_cmd_t *        cmd;
+   my_config_t *           ccnf;
+   const my_widget_t *     widget;
+
+   if ((rc = my_widget_batch_read(cnf, batch)) != 0)
+      return((rc < 0) ? 1 : 0);
+
+   // command is added to the window once requests may have been queued
+   cmd = &batch->cmds[(batch->head + batch->len) % batch->window];
+   memset(cmd, 0, sizeof(my_batch_cmd_t));
+   cmd->line = batch->line;
+
+   // split line into arguments using the quoting rules of the shell
+   if ((cmd->args = strdup(batch->input.data)) == NULL)
+   {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      my_widget_batch_free_cmd(cmd);
+      return(1);
+   };
+   if ((argc = my_widget_batch_split(cmd)) < 0)
+   {  fprintf(stderr, "%s: %s:%zu: %s\n", my_prog_name(cnf), batch->path, cmd->line, (argc == -EINVAL) ? "unterminated quote" : strerror(-argc));
+      my_widget_batch_free_cmd(cmd);
+      return(1);
+   };
+
+   // commands must complete with a reply to be batched
+   if ( ((widget = my_lookup_widget(cmd->argv[0], 0)) == NULL) || (widget->func_exec == &my_widget_batch) || (widget->func_exec == &my_widget_exporter) )
+   {  fprintf(stderr, "%s: %s:%zu: unknown or unsupported widget `%s'\n", my_prog_name(cnf), batch->path, cmd->line, cmd->argv[0]);
+      my_widget_batch_free_cmd(cmd);
+      return(1);
+   };
+
+   // command inherits options of batch, but not its parsing state
+   if ((ccnf = malloc(sizeof(my_config_t))) == NULL)
+   {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      my_widget_batch_free_cmd(cmd);
+      return(1);
+   };
+   memcpy(ccnf, cnf, sizeof(my_config_t));
+   cmd->cnf = ccnf;
+   memset(&ccnf->out,         0, sizeof(my_buffer_t));
+   memset(&ccnf->msg_buff,    0, sizeof(my_buffer_t));
+   memset(&ccnf->msg_stack,   0, sizeof(my_buffer_t));
+   memset(&ccnf->path,        0, sizeof(my_buffer_t));
+   memset(&ccnf->path_offs,   0, sizeof(my_buffer_t));
+   memset(&ccnf->tape,        0, sizeof(my_buffer_t));
+   memset(&ccnf->tape_data,   0, sizeof(my_buffer_t));
+   memset(&ccnf->replay_path, 0, sizeof(my_buffer_t));
+   memset(&ccnf->replay_offs, 0, sizeof(my_buffer_t));
+   memset(&ccnf->sects,       0, sizeof(my_buffer_t));
+   memset(&ccnf->sects_offs,  0, sizeof(my_buffer_t));
+   memset(&ccnf->names_data,  0, sizeof(my_buffer_t));
+   memset(&ccnf->stats,       0, sizeof(my_stats_t));
+   ccnf->names          = NULL;
+   ccnf->names_size     = 0;
+   ccnf->names_len      = 0;
+   ccnf->select         = NULL;
+   ccnf->select_len     = 0;
+   ccnf->where          = NULL;
+   ccnf->where_len      = 0;
+   ccnf->writer         = NULL;
+   ccnf->jobs           = NULL;
+   ccnf->emitter        = NULL;
+   ccnf->emitter_state  = NULL;
+   ccnf->out_capture    = &cmd->out;
+   ccnf->out_err        = 0;
+   ccnf->queued         = 0;
+   ccnf->res_id         = 0;
+   ccnf->res_last_id    = 0;
+   ccnf->res_count      = 0;
+   ccnf->widget         = widget;
+   ccnf->symlinked      = 0;
+   if ((ccnf->out.data = malloc(cnf->out.size)) == NULL)
+   {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      my_widget_batch_free_cmd(cmd);
+      return(1);
+   };
+   ccnf->out.size = cnf->out.size;
+
+   // projection and filter of batch were validated when its options were
+   // parsed, expressions of the command are added to the inherited filter
+   if ((my_parse_select(ccnf)))
+   {  my_widget_batch_free_cmd(cmd);
+      return(1);
+   };
+   for(pos = 0; (pos < cnf->where_len); pos++)
+   {  if ((my_parse_where(ccnf, cnf->where[pos].expr)))
+      {  my_widget_batch_free_cmd(cmd);
+         return(1);
+      };
+   };
+   if ((my_arguments(ccnf, argc, cmd->argv)))
+   {  fprintf(stderr, "%s: %s:%zu: invalid command\n", my_prog_name(cnf), batch->path, cmd->line);
+      my_widget_batch_free_cmd(cmd);
+      return(1);
+   };
+   // records of batched commands are formatted by the polling thread
+   ccnf->opt_jobs = 0;
+   if ( (!(widget->davici_cmd)) && (!(ccnf->alt_command)) )
+   {  fprintf(stderr, "%s: %s:%zu: events of `%s' are streamed and cannot be batched\n", my_prog_name(cnf), batch->path, cmd->line, widget->name);
+      my_widget_batch_free_cmd(cmd);
+      return(1);
+   };
+
+   // queue requests of command without polling for responses, requests
+   // queued before a failure are still awaited
+   my_verbose(cnf, "queueing %s:%zu: %s ...\n", batch->path, cmd->line, widget->name);
+   ccnf->stats.queued = my_time_ns();
+   batch->len++;
+   if ((widget->func_exec(ccnf)))
+      return(1);
+   cnf->queued += ccnf->queued;
+
+   return(0);
+}
+
+
+int
+my_widget_batch_read(
+         my_config_t *                 cnf,
+         my_batch_t *                  batch )
+{
+   size_t            len;
+   size_t            pos;
+   char *            ptr;
+
+   // read next line which is not blank or a comment
+   while (!(batch->eof))
+   {  batch->input.len = 0;
+      do
+      {  if ((ptr = my_buffer_alloc(&batch->input, MY_BUFF_SIZE)) == NULL)
+         {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+            return(-ENOMEM);
+         };
+         batch->input.len -= MY_BUFF_SIZE;
+         if (fgets(ptr, MY_BUFF_SIZE, batch->fp) == NULL)
+         {  if ((ferror(batch->fp)))
+            {  fprintf(stderr, "%s: %s: %s\n", my_prog_name(cnf), batch->path, strerror(errno));
+               return(-EIO);
+            };
+            batch->eof = 1;
+            ptr[0]     = '\0';
+         };
+         batch->input.len += strlen(ptr);
+      } while ( (!(batch->eof)) && ((batch->input.len)) && (batch->input.data[batch->input.len-1] != '\n') );
+      batch->line++;
+
+      len = batch->input.len;
+      while ( ((len)) && ((strchr(" \t\r\n", batch->input.data[len-1]))) )
+         batch->input.data[--len] = '\0';
+      for(pos = 0; ( (pos < len) && ((strchr(" \t", batch->input.data[pos]))) ); pos++);
+      if ( (pos < len) && (batch->input.data[pos] != '#') )
+         return(0);
+   };
+
+   return(1);
+}
+
+
+int
+my_widget_batch_split(
+         my_batch_cmd_t *              cmd )
+{
+   int               argc;
+   int               size;
+   char              quote;
+   char *            src;
+   char *            dst;
+   void *            ptr;
+
+   argc  = 0;
+   size  = 0;
+   src   = cmd->args;
+   dst   = cmd->args;
+
+   while ((*src))
+   {  // skip white space between arguments
+      if ( (*src == ' ') || (*src == '\t') )
+      {  src++;
+         continue;
+      };
+
+      // grow list of arguments, leaving room for terminating NULL
+      if ((argc + 1) >= size)
+      {  size += MY_BATCH_ARGS;
+         if ((ptr = realloc(cmd->argv, sizeof(char *) * (size_t)size)) == NULL)
+            return(-ENOMEM);
+         cmd->argv = ptr;
+      };
+      cmd->argv[argc++] = dst;
+
+      // copy argument in place, removing quotes and escapes
+      for(quote = '\0'; ( ((*src)) && ( ((quote)) || ( (*src != ' ') && (*src != '\t') ) ) ); src++)
+      {  if ( (*src == quote) && ((quote)) )
+            quote = '\0';
+         else if ( (!(quote)) && ( (*src == '\'') || (*src == '"') ) )
+            quote = *src;
+         else if ( (*src == '\\') && (quote != '\'') && ((src[1])) )
+            *dst++ = *++src;
+         else
+            *dst++ = *src;
+      };
+      if ((quote))
+         return(-EINVAL);
+      if ((*src))
+         src++;
+      *dst++ = '\0';
+   };
+   cmd->argv[argc] = NULL;
+
+   return(argc);
+}
+
+
+/* end of source */
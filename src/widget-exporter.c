@@ -0,0 +1,1023 @@
+/*
+ *  Davici Utilities for Strongswan
+ *  Copyright (C) 2026 David M. Syzdek <david@syzdek.net>.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions are
+ *  met:
+ *
+ *     1. Redistributions of source code must retain the above copyright
+ *        notice, this list of conditions and the following disclaimer.
+ *
+ *     2. Redistributions in binary form must reproduce the above copyright
+ *        notice, this list of conditions and the following disclaimer in the
+ *        documentation and/or other materials provided with the distribution.
+ *
+ *     3. Neither the name of the copyright holder nor the names of its
+ *        contributors may be used to endorse or promote products derived from
+ *        this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS
+ *  IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ *  PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+ *  LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ *  NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+ *  SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+#define __SRC_WIDGET_EXPORTER_C 1
+
+
+///////////////
+//           //
+//  Headers  //
+//           //
+///////////////
+// MARK: - Headers
+
+#include "davicictl.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include <poll.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include <davici.h>
+
+
+///////////////////
+//               //
+//  Definitions  //
+//               //
+///////////////////
+// MARK: - Definitions
+
+#define MY_EXPORTER_PORT         9814
+#define MY_EXPORTER_REFRESH      15
+#define MY_EXPORTER_CLIENTS      16
+#define MY_EXPORTER_IDLE         5000
+#define MY_EXPORTER_REQ_MAX      8192
+#define MY_EXPORTER_BACKOFF      1000
+#define MY_EXPORTER_BACKOFF_MAX  60000
+
+#define MY_EXPORTER_CONTENT_TYPE "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+
+/////////////////
+//             //
+//  Datatypes  //
+//             //
+/////////////////
+// MARK: - Datatypes
+
+typedef struct _my_exporter         my_exporter_t;
+typedef struct _my_exporter_client  my_exporter_client_t;
+
+
+struct _my_exporter_client
+{  int                           fd;
+   int                           is_head;
+   size_t                        sent;
+   int64_t                       since;
+   my_buffer_t                   req;
+   my_buffer_t                   res;
+};
+
+
+struct _my_exporter
+{  my_config_t *                 cnf;
+   int                           listen_fd;
+   int                           pending;
+   int                           abandoned;
+   int                           failed;
+   int                           success;
+   int64_t                       refresh;
+   int64_t                       refresh_at;
+   int64_t                       limit;
+   int64_t                       expire_at;
+   int64_t                       refreshed_at;
+   int64_t                       backoff;
+   int64_t                       reconnect_at;
+   my_buffer_t                   cache;
+   my_buffer_t                   next;
+   my_buffer_t                   body;
+   my_exporter_client_t          clients[MY_EXPORTER_CLIENTS];
+};
+
+
+//////////////////
+//              //
+//  Prototypes  //
+//              //
+//////////////////
+// MARK: - Prototypes
+
+static int
+my_widget_exporter_accept(
+         my_exporter_t *               exp,
+         int64_t                       now );
+
+
+static void
+my_widget_exporter_backoff(
+         my_exporter_t *               exp,
+         int64_t                       now );
+
+
+static void
+my_widget_exporter_cb_command(
+         struct davici_conn *          conn,
+         int                           err,
+         const char *                  name,
+         struct davici_response *      res,
+         void *                        user );
+
+
+static void
+my_widget_exporter_cb_event(
+         struct davici_conn *          conn,
+         int                           err,
+         const char *                  name,
+         struct davici_response *      res,
+         void *                        user );
+
+
+static void
+my_widget_exporter_close(
+         my_exporter_client_t *        client );
+
+
+static int
+my_widget_exporter_connect(
+         my_exporter_t *               exp,
+         int64_t                       now );
+
+
+static void
+my_widget_exporter_disconnect(
+         my_exporter_t *               exp,
+         int64_t                       now );
+
+
+static void
+my_widget_exporter_expire(
+         my_exporter_t *               exp );
+
+
+static void
+my_widget_exporter_free(
+         my_exporter_t *               exp );
+
+
+static int
+my_widget_exporter_listen(
+         my_exporter_t *               exp );
+
+
+static int64_t
+my_widget_exporter_now(
+         void );
+
+
+static int
+my_widget_exporter_queue(
+         my_exporter_t *               exp,
+         const char *                  command,
+         const char *                  event,
+         const char *                  key );
+
+
+static int
+my_widget_exporter_read(
+         my_exporter_t *               exp,
+         my_exporter_client_t *        client );
+
+
+static int
+my_widget_exporter_refresh(
+         my_exporter_t *               exp );
+
+
+static void
+my_widget_exporter_refreshed(
+         my_exporter_t *               exp );
+
+
+static int
+my_widget_exporter_respond(
+         my_exporter_t *               exp,
+         my_exporter_client_t *        client,
+         const char *                  status,
+         const char *                  body,
+         size_t                        len );
+
+
+static int
+my_widget_exporter_status(
+         my_exporter_t *               exp );
+
+
+static int
+my_widget_exporter_write(
+         my_exporter_client_t *        client );
+
+
+/////////////////
+//             //
+//  Functions  //
+//             //
+/////////////////
+// MARK: - Functions
+
+int
+my_widget_exporter(
+         my_config_t *                 cnf )
+{
+   int                     rc;
+   int                     timeout;
+   nfds_t                  nfds;
+   nfds_t                  pos;
+   size_t                  idx;
+   int64_t                 now;
+   int64_t                 wake;
+   my_exporter_t *         exp;
+   my_exporter_client_t *  client;
+   my_exporter_client_t *  polled[MY_EXPORTER_CLIENTS];
+   struct pollfd           pfds[MY_EXPORTER_CLIENTS + 3];
+
+   if (!(cnf))
+      return(1);
+
+   // the listener is served by the polling loop of a single socket
+   if ((cnf->sock))
+   {  fprintf(stderr, "%s: multiple vici sockets are not supported\n", my_prog_name(cnf));
+      return(1);
+   };
+   if ((exp = calloc(1, sizeof(my_exporter_t))) == NULL)
+   {  fprintf(stderr, "%s: out of virtual memory\n", my_prog_name(cnf));
+      return(1);
+   };
+   exp->cnf          = cnf;
+   exp->listen_fd    = -1;
+   exp->refresh      = (int64_t)(((cnf->opt_refresh)) ? cnf->opt_refresh : MY_EXPORTER_REFRESH) * 1000;
+   exp->limit        = ((cnf->opt_deadline)) ? (int64_t)cnf->opt_deadline : exp->refresh;
+   for(idx = 0; (idx < MY_EXPORTER_CLIENTS); idx++)
+      exp->clients[idx].fd = -1;
+
+   // replies are always formatted as metrics
+   cnf->format_out   = MY_FMT_OPENMETRICS;
+
+   if ((my_widget_exporter_listen(exp)))
+   {  my_widget_exporter_free(exp);
+      return(1);
+   };
+
+   // service vici socket, listener and scrapes until signaled to exit;
+   // scrapes are answered from the metrics of the last complete refresh
+   rc = 0;
+   exp->refresh_at = my_widget_exporter_now();
+   while ( (!(my_should_exit)) && (!(rc)) )
+   {  now = my_widget_exporter_now();
+
+      // reconnect to the daemon after the connection was lost
+      if ( (!(cnf->davici_conn)) && (now >= exp->reconnect_at) )
+         my_widget_exporter_connect(exp, now);
+
+      // refreshes which are not answered before the deadline are abandoned
+      if ( ((exp->pending)) && (now >= exp->expire_at) )
+         my_widget_exporter_expire(exp);
+
+      // refresh metrics unless the previous refresh is still pending, replies
+      // are received in order so a refresh is not queued behind the requests
+      // of an abandoned refresh
+      if ( ((cnf->davici_conn)) && (!(exp->pending)) && (!(exp->abandoned)) && (now >= exp->refresh_at) )
+      {  if ((rc = my_widget_exporter_refresh(exp)))
+            break;
+         exp->refresh_at = now + exp->refresh;
+         exp->expire_at  = now + exp->limit;
+      };
+
+      // close idle clients
+      if (!(cnf->davici_conn))
+         wake = exp->reconnect_at;
+      else if ((exp->pending))
+         wake = exp->expire_at;
+      else if ((exp->abandoned))
+         wake = now + MY_EXPORTER_IDLE;
+      else
+         wake = exp->refresh_at;
+      for(idx = 0; (idx < MY_EXPORTER_CLIENTS); idx++)
+      {  client = &exp->clients[idx];
+         if (client->fd == -1)
+            continue;
+         if ((now - client->since) >= MY_EXPORTER_IDLE)
+         {  my_widget_exporter_close(client);
+            continue;
+         };
+         wake = ((client->since + MY_EXPORTER_IDLE) < wake) ? (client->since + MY_EXPORTER_IDLE) : wake;
+      };
+
+      // build poll list
+      nfds              = 0;
+      pfds[nfds++]      = cnf->pollfd;
+      pfds[nfds].fd     = exp->listen_fd;
+      pfds[nfds].events = POLLIN;
+      nfds++;
+      pfds[nfds].fd     = cnf->signal_fd;
+      pfds[nfds].events = POLLIN;
+      nfds++;
+      for(idx = 0; (idx < MY_EXPORTER_CLIENTS); idx++)
+      {  client = &exp->clients[idx];
+         if (client->fd == -1)
+            continue;
+         pfds[nfds].fd     = client->fd;
+         pfds[nfds].events = ((client->res.len)) ? POLLOUT : POLLIN;
+         polled[nfds - 3]  = client;
+         nfds++;
+      };
+
+      timeout = (int)((wake > now) ? (wake - now) : 0);
+      if ((rc = poll(pfds, nfds, timeout)) < 0)
+      {  rc = 0;
+         if (errno == EINTR)
+            continue;
+         fprintf(stderr, "%s: poll(): %s\n", my_prog_name(cnf), strerror(errno));
+         rc = 1;
+         break;
+      };
+      if (!(rc))
+         continue;
+      rc  = 0;
+      now = my_widget_exporter_now();
+
+      // process signals
+      if ((pfds[2].revents & POLLIN))
+      {  my_signal(cnf);
+         if ((my_should_exit))
+            break;
+      };
+
+      // process vici socket, cached metrics continue to be served while
+      // the connection is lost
+      if ((pfds[0].revents & (POLLIN | POLLHUP | POLLERR)))
+      {  if ((rc = davici_read(cnf->davici_conn)) < 0)
+         {  fprintf(stderr, "%s: davici_read(): %s\n", my_prog_name(cnf), strerror(-rc));
+            my_widget_exporter_disconnect(exp, now);
+         };
+         rc = 0;
+      };
+      if ( ((cnf->davici_conn)) && ((pfds[0].revents & POLLOUT)) )
+      {  if ((rc = davici_write(cnf->davici_conn)) < 0)
+         {  fprintf(stderr, "%s: davici_write(): %s\n", my_prog_name(cnf), strerror(-rc));
+            my_widget_exporter_disconnect(exp, now);
+         };
+         rc = 0;
+      };
+
+      // process clients before accepting new clients
+      for(pos = 3; (pos < nfds); pos++)
+      {  client = polled[pos - 3];
+         if ((pfds[pos].revents & POLLOUT))
+            my_widget_exporter_write(client);
+         else if ((pfds[pos].revents & (POLLIN | POLLHUP | POLLERR)))
+            my_widget_exporter_read(exp, client);
+      };
+      if ((pfds[1].revents & POLLIN))
+         rc = my_widget_exporter_accept(exp, now);
+   };
+
+   my_widget_exporter_free(exp);
+
+   return(((rc)) ? 1 : 0);
+}
+
+
+int
+my_widget_exporter_accept(
+         my_exporter_t *               exp,
+         int64_t                       now )
+{
+   int                     fd;
+   int                     flags;
+   size_t                  idx;
+   my_exporter_client_t *  client;
+
+   while((fd = accept(exp->listen_fd, NULL, NULL)) != -1)
+   {  // reject clients which exceed the limit of concurrent scrapes
+      for(idx = 0; ( (idx < MY_EXPORTER_CLIENTS) && (exp->clients[idx].fd != -1) ); idx++);
+      if (idx == MY_EXPORTER_CLIENTS)
+      {  my_verbose(exp->cnf, "rejecting HTTP client: too many clients\n");
+         close(fd);
+         continue;
+      };
+      if ( ((flags = fcntl(fd, F_GETFL)) == -1) || (fcntl(fd, F_SETFL, flags | O_NONBLOCK) == -1) )
+      {  close(fd);
+         continue;
+      };
+      client            = &exp->clients[idx];
+      client->fd        = fd;
+      client->since     = now;
+      client->sent      = 0;
+      client->is_head   = 0;
+      client->req.len   = 0;
+      client->res.len   = 0;
+      my_verbose(exp->cnf, "accepted HTTP client ...\n");
+   };
+
+   switch(errno)
+   {  case EAGAIN:
+#if EAGAIN != EWOULDBLOCK
+      case EWOULDBLOCK:
+#endif
+      case EINTR:
+      case ECONNABORTED:
+         return(0);
+
+      // descriptors may be exhausted by clients, retry on next event
+      case EMFILE:
+      case ENFILE:
+         fprintf(stderr, "%s: accept(): %s\n", my_prog_name(exp->cnf), strerror(errno));
+         return(0);
+
+      default:
+         break;
+   };
+
+   fprintf(stderr, "%s: accept(): %s\n", my_prog_name(exp->cnf), strerror(errno));
+
+   return(1);
+}
+
+
+void
+my_widget_exporter_backoff(
+         my_exporter_t *               exp,
+         int64_t                       now )
+{
+   // delay between attempts doubles until a refresh succeeds
+   exp->backoff      = ((exp->backoff)) ? (exp->backoff * 2) : MY_EXPORTER_BACKOFF;
+   exp->backoff      = (exp->backoff < MY_EXPORTER_BACKOFF_MAX) ? exp->backoff : MY_EXPORTER_BACKOFF_MAX;
+   exp->reconnect_at = now + exp->backoff;
+   fprintf(stderr, "%s: reconnecting to vici socket in %" PRId64 " ms\n", my_prog_name(exp->cnf), exp->backoff);
+   return;
+}
+
+
+void
+my_widget_exporter_cb_command(
+         struct davici_conn *          conn,
+         int                           err,
+         const char *                  name,
+         struct davici_response *      res,
+         void *                        user )
+{
+   int               rc;
+   uint64_t          started;
+   my_exporter_t *   exp;
+
+   if (!(conn))
+      return;
+
+   exp = (my_exporter_t *)user;
+
+   // replies to requests of an abandoned refresh are ignored
+   if ((exp->abandoned))
+   {  my_verbose(exp->cnf, "ignoring late results of \"%s\" command ...\n", name);
+      exp->abandoned--;
+      return;
+   };
+
+   my_verbose(exp->cnf, "processing results of \"%s\" command ...\n", name);
+
+   exp->pending--;
+
+   if (err < 0)
+   {  fprintf(stderr, "%s: %s: %s\n", my_prog_name(exp->cnf), name, strerror(-err));
+      exp->failed = 1;
+   }
+   else if ((res))
+   {  started = my_time_ns();
+      if ((rc = my_parse_res(name, res, exp->cnf, 0)) < 0)
+      {  fprintf(stderr, "%s: %s: %s\n", my_prog_name(exp->cnf), name, strerror(-rc));
+         exp->failed = 1;
+      };
+      my_stats_message(exp->cnf, started, 1);
+   };
+
+   if (!(exp->pending))
+      my_widget_exporter_refreshed(exp);
+
+   return;
+}
+
+
+void
+my_widget_exporter_cb_event(
+         struct davici_conn *          conn,
+         int                           err,
+         const char *                  name,
+         struct davici_response *      res,
+         void *                        user )
+{
+   int               rc;
+   uint64_t          started;
+   my_exporter_t *   exp;
+
+   if (!(conn))
+      return;
+
+   exp = (my_exporter_t *)user;
+
+   if ((exp->abandoned))
+      return;
+   if (err < 0)
+   {  fprintf(stderr, "%s: %s: %s\n", my_prog_name(exp->cnf), name, strerror(-err));
+      exp->failed = 1;
+      return;
+   };
+   if (!(res))
+      return;
+
+   // streamed events contain one record per top level section
+   started           = my_time_ns();
+   exp->cnf->flags  |= MY_FLG_RECORDS;
+   rc                = my_parse_res(name, res, exp->cnf, 1);
+   exp->cnf->flags  &= ~MY_FLG_RECORDS;
+   my_stats_message(exp->cnf, started, 0);
+   if (rc < 0)
+   {  fprintf(stderr, "%s: %s: %s\n", my_prog_name(exp->cnf), name, strerror(-rc));
+      exp->failed = 1;
+   };
+
+   return;
+}
+
+
+void
+my_widget_exporter_close(
+         my_exporter_client_t *        client )
+{
+   if (client->fd == -1)
+      return;
+   close(client->fd);
+   client->fd        = -1;
+   client->req.len   = 0;
+   client->res.len   = 0;
+   client->sent      = 0;
+   return;
+}
+
+
+int
+my_widget_exporter_connect(
+         my_exporter_t *               exp,
+         int64_t                       now )
+{
+   int               rc;
+   my_config_t *     cnf;
+
+   cnf = exp->cnf;
+
+   my_verbose(cnf, "connecting to vici socket ...\n");
+   if ((rc = davici_connect_unix(cnf->vici_sockpath, my_davici_fdcb, cnf, &cnf->davici_conn)) < 0)
+   {  fprintf(stderr, "%s: %s: %s\n", my_prog_name(cnf), cnf->vici_sockpath, strerror(-rc));
+      cnf->davici_conn  = NULL;
+      cnf->pollfd.fd    = -1;
+      my_widget_exporter_backoff(exp, now);
+      return(rc);
+   };
+
+   // metrics are refreshed as soon as the connection is restored
+   exp->refresh_at = now;
+
+   return(0);
+}
+
+
+void
+my_widget_exporter_disconnect(
+         my_exporter_t *               exp,
+         int64_t                       now )
+{
+   my_config_t *     cnf;
+
+   cnf = exp->cnf;
+
+   // outstanding requests are abandoned along with the connection, and the
+   // metrics of the last complete refresh are served as stale
+   exp->abandoned   += exp->pending;
+   if ((exp->pending))
+   {  exp->pending   = 0;
+      exp->failed    = 1;
+      my_widget_exporter_refreshed(exp);
+   };
+   exp->success      = 0;
+
+   my_verbose(cnf, "disconnecting from vici socket ...\n");
+   davici_disconnect(cnf->davici_conn);
+   cnf->davici_conn  = NULL;
+   cnf->pollfd.fd    = -1;
+   exp->abandoned    = 0;
+
+   my_widget_exporter_backoff(exp, now);
+
+   return;
+}
+
+
+void
+my_widget_exporter_expire(
+         my_exporter_t *               exp )
+{
+   fprintf(stderr, "%s: deadline of %" PRId64 " ms expired (outstanding requests: %d)\n", my_prog_name(exp->cnf), exp->limit, exp->pending);
+
+   // replies which are still outstanding are discarded once received
+   exp->abandoned   += exp->pending;
+   exp->pending      = 0;
+   exp->failed       = 1;
+   my_widget_exporter_refreshed(exp);
+
+   return;
+}
+
+
+void
+my_widget_exporter_free(
+         my_exporter_t *               exp )
+{
+   size_t            idx;
+
+   if (!(exp))
+      return;
+
+   exp->cnf->out_capture = NULL;
+
+   for(idx = 0; (idx < MY_EXPORTER_CLIENTS); idx++)
+   {  my_widget_exporter_close(&exp->clients[idx]);
+      my_buffer_free(&exp->clients[idx].req);
+      my_buffer_free(&exp->clients[idx].res);
+   };
+
+   if (exp->listen_fd != -1)
+      close(exp->listen_fd);
+
+   my_buffer_free(&exp->cache);
+   my_buffer_free(&exp->next);
+   my_buffer_free(&exp->body);
+
+   free(exp);
+
+   return;
+}
+
+
+int
+my_widget_exporter_listen(
+         my_exporter_t *               exp )
+{
+   int                     opt;
+   int                     flags;
+   unsigned                port;
+   my_config_t *           cnf;
+   struct sockaddr_in      sa;
+
+   cnf   = exp->cnf;
+   port  = ((cnf->opt_port)) ? cnf->opt_port : MY_EXPORTER_PORT;
+
+   memset(&sa, 0, sizeof(sa));
+   sa.sin_family        = AF_INET;
+   sa.sin_port          = htons((uint16_t)port);
+   sa.sin_addr.s_addr   = htonl(INADDR_LOOPBACK);
+
+   my_verbose(cnf, "listening on 127.0.0.1:%u ...\n", port);
+
+   if ((exp->listen_fd = socket(AF_INET, SOCK_STREAM, 0)) == -1)
+   {  fprintf(stderr, "%s: socket(): %s\n", my_prog_name(cnf), strerror(errno));
+      return(1);
+   };
+
+   opt = 1;
+   setsockopt(exp->listen_fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+   if ((bind(exp->listen_fd, (struct sockaddr *)&sa, sizeof(sa))))
+   {  fprintf(stderr, "%s: bind(127.0.0.1:%u): %s\n", my_prog_name(cnf), port, strerror(errno));
+      return(1);
+   };
+   if ((listen(exp->listen_fd, MY_EXPORTER_CLIENTS)))
+   {  fprintf(stderr, "%s: listen(): %s\n", my_prog_name(cnf), strerror(errno));
+      return(1);
+   };
+   if ( ((flags = fcntl(exp->listen_fd, F_GETFL)) == -1) || (fcntl(exp->listen_fd, F_SETFL, flags | O_NONBLOCK) == -1) )
+   {  fprintf(stderr, "%s: fcntl(): %s\n", my_prog_name(cnf), strerror(errno));
+      return(1);
+   };
+
+   return(0);
+}
+
+
+int64_t
+my_widget_exporter_now(
+         void )
+{
+   struct timespec         ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return(((int64_t)ts.tv_sec * 1000) + (ts.tv_nsec / 1000000));
+}
+
+
+int
+my_widget_exporter_queue(
+         my_exporter_t *               exp,
+         const char *                  command,
+         const char *                  event,
+         const char *                  key )
+{
+   int                     rc;
+   my_config_t *           cnf;
+   struct davici_request * req;
+
+   cnf = exp->cnf;
+
+   // initialize new command
+   my_verbose(cnf, "initializing vici command \"%s\" ...\n", command);
+   if ((rc = davici_new_cmd(command, &req)) < 0)
+   {  fprintf(stderr, "%s: %s\n", my_prog_name(cnf), strerror(-rc));
+      return(1);
+   };
+
+   // add arguments
+   if ((key))
+      davici_kv(req, key, "yes", (unsigned)strlen("yes"));
+
+   // queue command
+   if ((event))
+   {  my_verbose(cnf, "queueing vici command \"%s\" with event \"%s\" ...\n", command, event);
+      rc = davici_queue_streamed(cnf->davici_conn, req, my_widget_exporter_cb_command, event, my_widget_exporter_cb_event, exp);
+   } else
+   {  my_verbose(cnf, "queueing vici command \"%s\" ...\n", command);
+      rc = davici_queue(cnf->davici_conn, req, my_widget_exporter_cb_command, exp);
+   };
+   if (rc < 0)
+   {  fprintf(stderr, "%s: %s\n", my_prog_name(cnf), strerror(-rc));
+      my_verbose(cnf, "canceling vici command \"%s\" ...\n", command);
+      davici_cancel(req);
+      return(1);
+   };
+   exp->pending++;
+
+   return(0);
+}
+
+
+int
+my_widget_exporter_read(
+         my_exporter_t *               exp,
+         my_exporter_client_t *        client )
+{
+   ssize_t           rc;
+   size_t            len;
+   char *            ptr;
+   char *            method;
+   char *            target;
+
+   // append request to buffer, the NUL terminator is not counted
+   if ((ptr = my_buffer_alloc(&client->req, 1024)) == NULL)
+   {  my_widget_exporter_close(client);
+      return(-ENOMEM);
+   };
+   client->req.len -= 1024;
+   if ((rc = read(client->fd, ptr, 1023)) <= 0)
+   {  if ( (rc < 0) && ( (errno == EAGAIN) || (errno == EINTR) ) )
+         return(0);
+      my_widget_exporter_close(client);
+      return(0);
+   };
+   client->req.len           += (size_t)rc;
+   client->req.data[client->req.len] = '\0';
+
+   // wait for end of request header
+   if (strstr(client->req.data, "\r\n\r\n") == NULL)
+   {  if (client->req.len < MY_EXPORTER_REQ_MAX)
+         return(0);
+      return(my_widget_exporter_respond(exp, client, "431 Request Header Fields Too Large", NULL, 0));
+   };
+
+   // parse request line
+   method = client->req.data;
+   if ((target = strchr(method, ' ')) == NULL)
+      return(my_widget_exporter_respond(exp, client, "400 Bad Request", NULL, 0));
+   *target++ = '\0';
+   len = strcspn(target, " ?\r\n");
+   target[len] = '\0';
+
+   client->is_head = (!(strcmp(method, "HEAD"))) ? 1 : 0;
+   if ( (strcmp(method, "GET") != 0) && (!(client->is_head)) )
+      return(my_widget_exporter_respond(exp, client, "405 Method Not Allowed", NULL, 0));
+   if ((strcmp(target, "/metrics") != 0))
+      return(my_widget_exporter_respond(exp, client, "404 Not Found", NULL, 0));
+   if (!(exp->cache.len))
+      return(my_widget_exporter_respond(exp, client, "503 Service Unavailable", NULL, 0));
+
+   my_verbose(exp->cnf, "serving cached metrics to HTTP client ...\n");
+
+   if (my_widget_exporter_status(exp) < 0)
+   {  my_widget_exporter_close(client);
+      return(-ENOMEM);
+   };
+
+   return(my_widget_exporter_respond(exp, client, "200 OK", exp->body.data, exp->body.len));
+}
+
+
+int
+my_widget_exporter_refresh(
+         my_exporter_t *               exp )
+{
+   my_verbose(exp->cnf, "refreshing metrics ...\n");
+
+   // capture formatted replies until all commands have completed
+   exp->failed             = 0;
+   exp->next.len           = 0;
+   exp->cnf->out_capture   = &exp->next;
+   exp->cnf->stats.queued  = my_time_ns();
+
+   if ((my_widget_exporter_queue(exp, "stats", NULL, NULL)))
+      return(1);
+   if ((my_widget_exporter_queue(exp, "get-counters", NULL, "all")))
+      return(1);
+   if ((my_widget_exporter_queue(exp, "list-sas", "list-sa", "noblock")))
+      return(1);
+
+   return(0);
+}
+
+
+void
+my_widget_exporter_refreshed(
+         my_exporter_t *               exp )
+{
+   my_buffer_t       swap;
+   my_config_t *     cnf;
+   struct timespec   ts;
+
+   cnf = exp->cnf;
+
+   // complete metrics of the refresh
+   if (my_parse_footer(cnf) < 0)
+      exp->failed = 1;
+   if (my_out_flush(cnf) < 0)
+      exp->failed = 1;
+   cnf->res_last_id     = 0;
+   cnf->res_count       = 0;
+   cnf->out_capture     = NULL;
+
+   // metrics of failed refreshes are discarded and the previous metrics
+   // continue to be served
+   if ((exp->failed))
+   {  fprintf(stderr, "%s: refresh failed, serving previous metrics\n", my_prog_name(cnf));
+      exp->next.len  = 0;
+      exp->success   = 0;
+      return;
+   };
+
+   swap           = exp->cache;
+   exp->cache     = exp->next;
+   exp->next      = swap;
+   exp->next.len  = 0;
+
+   clock_gettime(CLOCK_REALTIME, &ts);
+   exp->success      = 1;
+   exp->backoff      = 0;
+   exp->refreshed_at = ((int64_t)ts.tv_sec * 1000) + (ts.tv_nsec / 1000000);
+
+   my_verbose(cnf, "refreshed metrics (%zu bytes)\n", exp->cache.len);
+
+   return;
+}
+
+
+int
+my_widget_exporter_respond(
+         my_exporter_t *               exp,
+         my_exporter_client_t *        client,
+         const char *                  status,
+         const char *                  body,
+         size_t                        len )
+{
+   int               rc;
+   char              hdr[256];
+   char *            ptr;
+   const char *      type;
+
+   (void)exp;
+
+   // errors are described by the status line
+   type = MY_EXPORTER_CONTENT_TYPE;
+   if (!(body))
+   {  type  = "text/plain; charset=utf-8";
+      body  = &status[4];
+      len   = strlen(body);
+   };
+
+   rc = snprintf(
+      hdr, sizeof(hdr),
+      "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+      status, type, len
+   );
+
+   // responses are copied so later refreshes do not alter them
+   client->res.len   = 0;
+   client->sent      = 0;
+   len               = ((client->is_head)) ? 0 : len;
+   if ((ptr = my_buffer_alloc(&client->res, (size_t)rc + len)) == NULL)
+   {  my_widget_exporter_close(client);
+      return(-ENOMEM);
+   };
+   memcpy(ptr, hdr, (size_t)rc);
+   if ((len))
+      memcpy(&ptr[rc], body, len);
+
+   return(my_widget_exporter_write(client));
+}
+
+
+int
+my_widget_exporter_status(
+         my_exporter_t *               exp )
+{
+   int               rc;
+   size_t            len;
+   char *            ptr;
+   char              buff[512];
+
+   // metrics of the last complete refresh are followed by the outcome of
+   // the latest refresh, so metrics served after failed or expired
+   // refreshes can be recognized as stale
+   len = exp->cache.len;
+   if ( (len >= 6) && (!(memcmp(&exp->cache.data[len - 6], "# EOF\n", 6))) )
+      len -= 6;
+
+   rc = snprintf(
+      buff, sizeof(buff),
+      "# TYPE davici_scrape_success gauge\n"
+      "# HELP davici_scrape_success Whether the latest refresh of metrics succeeded.\n"
+      "davici_scrape_success %i\n"
+      "# TYPE davici_last_refresh_timestamp_seconds gauge\n"
+      "# HELP davici_last_refresh_timestamp_seconds Time of the last successful refresh of metrics.\n"
+      "davici_last_refresh_timestamp_seconds %" PRId64 ".%03i\n"
+      "# EOF\n",
+      exp->success, (exp->refreshed_at / 1000), (int)(exp->refreshed_at % 1000)
+   );
+
+   exp->body.len = 0;
+   if ((ptr = my_buffer_alloc(&exp->body, len + (size_t)rc)) == NULL)
+      return(-ENOMEM);
+   memcpy(ptr, exp->cache.data, len);
+   memcpy(&ptr[len], buff, (size_t)rc);
+
+   return(0);
+}
+
+
+int
+my_widget_exporter_write(
+         my_exporter_client_t *        client )
+{
+   ssize_t           rc;
+
+   while (client->sent < client->res.len)
+   {  if ((rc = write(client->fd, &client->res.data[client->sent], (client->res.len - client->sent))) < 0)
+      {  if (errno == EINTR)
+            continue;
+         if (errno == EAGAIN)
+            return(0);
+         my_widget_exporter_close(client);
+         return(0);
+      };
+      client->sent += (size_t)rc;
+   };
+
+   my_widget_exporter_close(client);
+
+   return(0);
+}
+
+
+/* end of source */